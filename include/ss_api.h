@@ -8,12 +8,22 @@
 #include <tinyxml2.h>
 
 #include "ss_curl.h"
+#include "ss_curlmulti.h"
 #include "ss_io.h"
+#include "ss_cache.h"
+#include "ss_crc32.h"
+#include "ss_hashcache.h"
+#include "ss_snapshot.h"
+#include "ss_watcher.h"
 #include "ss_game.h"
 #include "ss_user.h"
+#include "ss_ratelimiter.h"
+#include "ss_xmlstream.h"
+#include "ss_gamestream.h"
 #include "ss_gameinfo.h"
 #include "ss_gamesearch.h"
 #include "ss_gamelist.h"
+#include "ss_gamestore.h"
 #include "ss_mediasgamelist.h"
 #include "ss_systemlist.h"
 
@@ -88,7 +98,8 @@ namespace ss_api {
         static tinyxml2::XMLElement *addXmlElement(tinyxml2::XMLDocument *doc, tinyxml2::XMLElement *parent,
                                                    const std::string &name, const std::string &value);
 
-        static std::string getFileCrc(const std::string &path);
+        // large files are split in ranges hashed by "threads" workers (0: cpu count) then combined
+        static std::string getFileCrc(const std::string &path, int threads = 0);
 
 #ifdef __WINDOWS__
         static void printc(int color, const char* format, ...);
@@ -101,6 +112,8 @@ namespace ss_api {
         static std::string ss_devid;
         static std::string ss_devpassword;
         static std::string ss_softname;
+        // api endpoint, with trailing slash (can be changed for a local/mock server)
+        static std::string ss_baseurl;
     };
 }
 
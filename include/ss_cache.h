@@ -0,0 +1,31 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_CACHE_H
+#define SS_CACHE_H
+
+#include <string>
+
+namespace ss_api {
+
+    // persistent api responses cache, one (zlib compressed) file per entry.
+    // negative entries (error code, no data) allow to skip known "not found" requests
+    class Cache {
+
+    public:
+
+        // enable the cache in "path", entries older than "ttl" seconds (negative entries: "negativeTtl") are ignored
+        static void setup(const std::string &path, long ttl, long negativeTtl);
+
+        static bool isEnabled();
+
+        // returns true if a valid entry exists for "key", "code" is the http code of the cached response
+        static bool get(const std::string &key, std::string *data, long *code);
+
+        // store a response (code == 0) or a negative entry (code != 0)
+        static bool put(const std::string &key, const std::string &data, long code = 0);
+    };
+}
+
+#endif //SS_CACHE_H
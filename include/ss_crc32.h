@@ -0,0 +1,27 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_CRC32_H
+#define SS_CRC32_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ss_api {
+
+    // zlib compatible crc32 (reflected 0xedb88320 polynomial). the implementation is chosen at runtime:
+    // pclmulqdq folding (x86_64), armv8 crc instructions (aarch64), or slicing-by-8 tables
+    class Crc32 {
+
+    public:
+
+        // crc = Crc32::update(0, data, size), then chain calls with the previous crc
+        static uint32_t update(uint32_t crc, const void *data, size_t size);
+
+        // name of the selected implementation ("pclmul", "armv8", "slice8")
+        static const char *getName();
+    };
+}
+
+#endif //SS_CRC32_H
@@ -6,6 +6,7 @@
 #define SS_CURL_H
 
 #include <string>
+#include <functional>
 #if !defined(__WINDOWS__) && !defined(fd_set)
 #include <sys/select.h>
 #endif
@@ -17,16 +18,79 @@ namespace ss_api {
 
     public:
 
+        // called for each received data chunk, return false to abort the transfer
+        typedef std::function<bool(const char *data, size_t size)> StreamCb;
+
+        // response headers handling
+        struct Headers {
+            // response buffer, capacity reserved from "Content-Length" (optional),
+            // unless the response is compressed ("Content-Length" is then the encoded size)
+            std::string *data = nullptr;
+            // "Retry-After" (seconds, 0 if none)
+            long retryAfter = 0;
+            // current response "Content-Length" and "Content-Encoding"
+            size_t contentLength = 0;
+            bool encoded = false;
+        };
+
+        // response body size, on the wire (compressed) and decoded
+        struct Transfer {
+            size_t wireSize = 0;
+            size_t size = 0;
+        };
+
+        // borrow a warm easy handle from the pool (returned on destruction)
         Curl();
 
         ~Curl();
 
+        Curl(const Curl &) = delete;
+
+        Curl &operator=(const Curl &) = delete;
+
         std::string getString(const std::string &url, int timeout, long *http_code);
 
+        // same as above, but the response is written to "data" (capacity is kept, see getBuffer)
+        int getString(const std::string &url, int timeout, long *http_code, std::string *data);
+
         int getData(const std::string &url, const std::string &dstPath, int timeout, long *http_code);
 
+        int getStream(const std::string &url, int timeout, long *http_code, const StreamCb &cb);
+
         std::string escape(const std::string &url);
 
+        // options common to all requests
+        static void setOptions(CURL *handle, const std::string &url, int timeout);
+
+        // write the response body to "data"
+        static void setBuffer(CURL *handle, std::string *data);
+
+        // parse response headers to "headers"
+        static void setHeaders(CURL *handle, Headers *headers);
+
+        // reusable response buffer of the calling thread, avoid allocations for each response
+        static std::string &getBuffer();
+
+        // pool handling, handles are shared (dns, tls sessions, connections) between all threads
+        static CURL *acquire();
+
+        static void release(CURL *handle);
+
+        // free all pooled handles (call once, when all requests are done)
+        static void cleanup();
+
+        // get "handle" last transfer sizes ("size" is the decoded size) and add them to the totals
+        static Transfer getTransfer(CURL *handle, size_t size);
+
+        // all requests transfers since start
+        static Transfer getTotal();
+
+        // last request transfer
+        Transfer transfer;
+
+        // last request "Retry-After" header value (seconds, 0 if none)
+        long retryAfter = 0;
+
     private:
 
         CURL *curl = nullptr;
@@ -0,0 +1,64 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_CURLMULTI_H
+#define SS_CURLMULTI_H
+
+#include <string>
+#include <functional>
+#include <future>
+#include "ss_curl.h"
+
+namespace ss_api {
+
+    // event driven request engine: all requests run concurrently on a single i/o thread (curl_multi),
+    // the number of requests in flight is limited by "maxRequests" (screenscraper "maxthreads")
+    class CurlMulti {
+
+    public:
+
+        struct Response {
+            std::string data;
+            // same as Curl::getString: 0 on success, http or curl error code otherwise
+            long http_code = 0;
+            // curl result
+            int res = 0;
+            Curl::Transfer transfer;
+            // "Retry-After" header value (seconds, 0 if none)
+            long retryAfter = 0;
+        };
+
+        // callbacks are called from the i/o thread, they should not block
+        typedef std::function<void(const Response &)> Callback;
+
+        static bool start(int maxRequests);
+
+        // wait for all queued requests to complete, then stop the i/o thread
+        static void stop();
+
+        static bool isRunning();
+
+        // if retry, requests are re-queued on 429 or timeout (delay from RateLimiter::getRetryDelay),
+        // api requests (getString, getStream) are paced by the RateLimiter
+        static void getString(const std::string &url, int timeout, const Callback &cb, bool retry = true);
+
+        static void getData(const std::string &url, const std::string &dstPath,
+                            int timeout, const Callback &cb, bool retry = true);
+
+        // "stream" is called from the i/o thread for each received chunk,
+        // and with (nullptr, 0) when the request is about to be retried (restart parsing)
+        static void getStream(const std::string &url, int timeout,
+                              const Curl::StreamCb &stream, const Callback &cb, bool retry = true);
+
+        static std::future<Response> getString(const std::string &url, int timeout, bool retry = true);
+
+        static std::future<Response> getData(const std::string &url, const std::string &dstPath,
+                                             int timeout, bool retry = true);
+
+        static std::future<Response> getStream(const std::string &url, int timeout,
+                                               const Curl::StreamCb &stream, bool retry = true);
+    };
+}
+
+#endif //SS_CURLMULTI_H
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <vector>
+#include <future>
 #include <tinyxml2.h>
 
 #include "ss_sytem.h"
@@ -60,7 +61,11 @@ namespace ss_api {
             std::string type;
             std::string format;
 
-            int download(const std::string &dstPath, int retryDelay = 10);
+            // 429 and timeouts are retried if "retry"
+            int download(const std::string &dstPath, bool retry = true);
+
+            // use the request engine (CurlMulti) if running, else download synchronously
+            std::future<int> downloadAsync(const std::string &dstPath, bool retry = true);
         };
 
         Game::Media getMedia(const std::string &type) const;
@@ -70,6 +75,8 @@ namespace ss_api {
         static bool parseGame(Game *game, tinyxml2::XMLNode *gameNode,
                               const std::string &romName, int format);
 
+        static int parsePlayers(const std::string &players);
+
         unsigned long id = 0;
         int rating = 0;
         int rotation = 0;
@@ -5,16 +5,41 @@
 #ifndef SSCRAP_SS_GAMEINFO_H
 #define SSCRAP_SS_GAMEINFO_H
 
+#include <functional>
+#include "ss_gamestream.h"
+
 namespace ss_api {
 
     class GameInfo {
     public:
+        typedef std::function<void(GameInfo &)> Callback;
+
         GameInfo() = default;
 
+        // 429 and timeouts are retried if "retry" (see User)
         GameInfo(const std::string &crc, const std::string &md5, const std::string &sha1,
                  const std::string &systemeid, const std::string &romtype,
                  const std::string &romnom, const std::string &romtaille, const std::string &gameid,
-                 const std::string &ssid = "", const std::string &sspassword = "", int retryDelay = 10);
+                 const std::string &ssid = "", const std::string &sspassword = "", bool retry = true);
+
+        // use the request engine (CurlMulti) if running, "cb" is then called from the engine thread
+        static void getAsync(const std::string &crc, const std::string &md5, const std::string &sha1,
+                             const std::string &systemeid, const std::string &romtype,
+                             const std::string &romnom, const std::string &romtaille, const std::string &gameid,
+                             const std::string &ssid, const std::string &sspassword,
+                             const Callback &cb, bool retry = true);
+
+        static std::string getUrl(const std::string &crc, const std::string &md5, const std::string &sha1,
+                                  const std::string &systemeid, const std::string &romtype,
+                                  const std::string &romnom, const std::string &romtaille, const std::string &gameid,
+                                  const std::string &ssid, const std::string &sspassword);
+
+        // cache key (hashes, system and rom type), empty if the cache is disabled
+        static std::string getCacheKey(const std::string &crc, const std::string &md5, const std::string &sha1,
+                                       const std::string &systemeid, const std::string &romtype,
+                                       const std::string &romnom, const std::string &gameid);
+
+        void parse(const GameStream &stream, long code);
 
         Game game;
         int http_error = 0;
@@ -7,10 +7,31 @@
 
 #include <string>
 #include <functional>
+#include <unordered_map>
 #include "ss_systemlist.h"
 
 namespace ss_api {
 
+    // roms folder files of GameList and GameStore "append" (the snapshot listing is reused when current),
+    // for games availability: each file is matched by a single game
+    class RomFiles {
+    public:
+
+        RomFiles(const std::string &romPath, const std::vector<std::string> &filters);
+
+        // true if "path" is a file not matched yet, which is now matched
+        bool match(const std::string &path);
+
+        // games for the files not matched by any game ("unknown" files, not in database)
+        std::vector<Game> getUnmatchedGames(const System &system) const;
+
+    private:
+        std::string romPath;
+        std::vector<Io::File> files;
+        std::unordered_map<std::string, size_t> index;
+        std::vector<bool> matched;
+    };
+
     class GameList {
     public:
 
@@ -29,6 +50,9 @@ namespace ss_api {
                     const std::vector<std::string> &filters = {".zip"}, const System &system = {0, 0, "UNKNOWN"},
                     bool availableOnly = false, const GameAddedCb &cb = nullptr);
 
+        // append a game to "games", updating the indexes
+        void add(const Game &game);
+
         void sortAlpha(bool byZipName = false, bool gamesOnly = true);
 
         GameList filter(bool available = false, bool clones = false,
@@ -51,6 +75,22 @@ namespace ss_api {
 
         Game findGameByPathAndSystem(const std::string &path, int systemId);
 
+        // lookups by hash indexes, returning pointers to "games" (nullptr if not found).
+        // indexes are built by "append", kept up to date by "add" and rebuilt after "remove" and "sortAlpha".
+        // "games" can still be modified directly, but "invalidate" must then be called: until the next lookup
+        // rebuilds them, keys missing from the indexes are found by a linear search (slow), and "getGamesByName"
+        // may miss games added or renamed since. lookups are read only (safe concurrently) while the indexes
+        // are current
+        Game *getGameById(unsigned long romId);
+
+        Game *getGameByPath(const std::string &path);
+
+        Game *getGameByPathAndSystem(const std::string &path, int systemId);
+
+        std::vector<Game *> getGamesByName(const std::string &name);
+
+        void invalidate();
+
         Game::Editor findEditorByName(const std::string &name);
 
         std::vector<std::string> getEditorNames();
@@ -94,6 +134,20 @@ namespace ss_api {
         std::vector<int> rotations;
         std::vector<std::string> resolutions;
         std::vector<std::string> dates;
+
+    private:
+        void updateIndexes();
+
+        // first game of each key, "next" vectors chain the following games sharing the same key
+        std::unordered_map<unsigned long, size_t> idIndex;
+        std::unordered_map<std::string, size_t> pathIndex;
+        std::unordered_map<std::string, size_t> nameIndex;
+        std::vector<size_t> nextPath;
+        std::vector<size_t> nextName;
+        // "games" storage when the indexes were built
+        const Game *indexData = nullptr;
+        size_t indexSize = 0;
+        bool indexValid = false;
     };
 }
 
@@ -15,8 +15,9 @@ namespace ss_api {
     public:
         GameSearch() = default;
 
+        // 429 and timeouts are retried if "retry" (see User)
         GameSearch(const std::string &recherche, const std::string &systemeid,
-                   const std::string &ssid = "", const std::string &sspassword = "", int retryDelay = 10);
+                   const std::string &ssid = "", const std::string &sspassword = "", bool retry = true);
 
         User user;
         std::vector<Game> games;
@@ -0,0 +1,159 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_GAMESTORE_H
+#define SS_GAMESTORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "ss_game.h"
+
+namespace ss_api {
+
+    // unique strings storage, strings are referenced by id (0 is the empty string)
+    class StringPool {
+
+    public:
+
+        StringPool();
+
+        uint32_t intern(const std::string &str);
+
+        // returns StringPool::npos if "str" was never interned
+        uint32_t find(const std::string &str) const;
+
+        const std::string &get(uint32_t id) const { return strings[id]; }
+
+        size_t size() const { return strings.size(); }
+
+        size_t getMemoryUsage() const;
+
+        static const uint32_t npos = UINT32_MAX;
+
+    private:
+        std::vector<std::string> strings;
+        std::unordered_map<std::string, uint32_t> ids;
+    };
+
+    // compact (columnar) games storage, an alternative to GameList for big lists on low memory devices:
+    // numeric fields are stored in contiguous columns, repeated strings (system, editor, developer, genre,
+    // date, media type...) are interned in a string pool and per game strings (name, path...) share one buffer.
+    // games are referenced by row, and rebuilt as Game objects on demand. filtering lists (GameList "editors",
+    // "genres"...) are built from the columns on demand.
+    // returned strings pointers are valid until the next add
+    class GameStore {
+
+    public:
+
+        GameStore();
+
+        // load games from a gamelist/dat file, see GameList::append (games are not sorted)
+        bool append(const std::string &xmlPath, const std::string &romPath = "",
+                    const std::vector<std::string> &filters = {".zip"}, const System &system = {0, 0, "UNKNOWN"},
+                    bool availableOnly = false);
+
+        void add(const Game &game);
+
+        void reserve(size_t count);
+
+        void clear();
+
+        size_t size() const { return ids.size(); }
+
+        Game get(size_t row) const;
+
+        unsigned long getId(size_t row) const { return ids[row]; }
+
+        const char *getName(size_t row) const { return getText(names[row]); }
+
+        const char *getPath(size_t row) const { return getText(paths[row]); }
+
+        int getSystemId(size_t row) const { return systemIds[row]; }
+
+        bool isAvailable(size_t row) const { return (flags[row] & Available) != 0; }
+
+        bool isClone(size_t row) const { return (flags[row] & Clone) != 0; }
+
+        // filtering lists, in the order and with the items of GameList lists after the same appends
+        std::vector<System> getSystems() const;
+
+        std::vector<Game::Editor> getEditors() const;
+
+        std::vector<Game::Developer> getDevelopers() const;
+
+        std::vector<Game::Genre> getGenres() const;
+
+        std::vector<int> getPlayers() const;
+
+        std::vector<int> getRatings() const;
+
+        std::vector<int> getRotations() const;
+
+        std::vector<std::string> getResolutions() const;
+
+        std::vector<std::string> getDates() const;
+
+        // rows matching the filters, see GameList::filter
+        std::vector<uint32_t> filter(bool available = false, bool clones = false,
+                                     int system = -1, int parent_system = -1, int editor = -1, int developer = -1,
+                                     int players = -1, int rating = -1, int rotation = -1, int genre = -1,
+                                     const std::string &resolution = "ALL", const std::string &date = "ALL") const;
+
+        // sort rows by name (or path), case insensitive
+        void sort(std::vector<uint32_t> *rows, bool byPath = false) const;
+
+        // approximate heap usage, in bytes
+        size_t getMemoryUsage() const;
+
+    private:
+        enum Flags {
+            Available = 1,
+            Clone = 2,
+            // "unknown" file (not in database)
+            Unknown = 4
+        };
+
+        uint32_t addText(const std::string &str);
+
+        const char *getText(uint32_t offset) const { return text.c_str() + offset; }
+
+        StringPool pool;
+        // null terminated per game strings
+        std::string text;
+
+        std::vector<unsigned long> ids;
+        std::vector<uint8_t> flags;
+        std::vector<int16_t> ratings;
+        std::vector<int16_t> rotations;
+        std::vector<int16_t> players;
+        std::vector<int32_t> systemIds;
+        std::vector<int32_t> systemParentIds;
+        std::vector<int32_t> editorIds;
+        std::vector<int32_t> developerIds;
+        std::vector<int32_t> genreIds;
+        // pool ids
+        std::vector<uint32_t> systemNames;
+        std::vector<uint32_t> editorNames;
+        std::vector<uint32_t> developerNames;
+        std::vector<uint32_t> genreNames;
+        std::vector<uint32_t> dates;
+        std::vector<uint32_t> resolutions;
+        std::vector<uint32_t> playersNames;
+        std::vector<uint32_t> cloneOfs;
+        std::vector<uint32_t> romsPaths;
+        // text offsets
+        std::vector<uint32_t> names;
+        std::vector<uint32_t> paths;
+        std::vector<uint32_t> synopses;
+        // game medias are rows mediaStarts[row] to mediaStarts[row + 1]
+        std::vector<uint32_t> mediaStarts;
+        std::vector<uint32_t> mediaTypes;
+        std::vector<uint32_t> mediaFormats;
+        std::vector<uint32_t> mediaUrls;
+    };
+}
+
+#endif //SS_GAMESTORE_H
@@ -0,0 +1,60 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_GAMESTREAM_H
+#define SS_GAMESTREAM_H
+
+#include <string>
+#include <vector>
+#include "ss_xmlstream.h"
+#include "ss_game.h"
+#include "ss_user.h"
+
+namespace ss_api {
+
+    // fill games directly from a screenscraper "jeuInfos" or "jeuRecherche" response while it's received,
+    // same result as Game::parseGame (ScreenScraper format) without building the xml document
+    class GameStream : public XmlStream {
+
+    public:
+
+        explicit GameStream(const std::string &romName = "");
+
+        void reset();
+
+        std::vector<Game> games;
+        User user;
+
+        bool hasData = false;
+        bool hasUser = false;
+        bool hasGames = false;
+
+    protected:
+
+        void onStartElement(const std::string &name, const Attributes &attributes, size_t depth) override;
+
+        void onEndElement(const std::string &name, const std::string &text, size_t depth) override;
+
+    private:
+
+        bool seen(const std::string &name);
+
+        std::string romName;
+        Game game;
+        size_t gameDepth = 0;
+        std::vector<std::string> seenElements;
+        Attributes parentAttributes;
+        Attributes attributes;
+        bool isActive = false;
+        std::string firstName, worName;
+        std::string firstSynopsis, enSynopsis;
+        std::string firstDate, worDate;
+        bool hasFirstName = false, hasWorName = false;
+        bool hasFirstSynopsis = false, hasEnSynopsis = false;
+        bool hasFirstDate = false, hasWorDate = false;
+        bool hasEnGenre = false;
+    };
+}
+
+#endif //SS_GAMESTREAM_H
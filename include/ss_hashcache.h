@@ -0,0 +1,43 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_HASHCACHE_H
+#define SS_HASHCACHE_H
+
+#include <string>
+
+namespace ss_api {
+
+    // persistent file hashes store (typically a sidecar file in the roms folder).
+    // entries are keyed by path, relative to the store directory (only files in this directory are cached),
+    // and validated with the file stat signature (size, mtime, inode), so unchanged files are never hashed again
+    class HashCache {
+
+    public:
+
+        enum Type {
+            Crc = 0,    // whole file crc
+            RomCrc,     // first zip entry crc
+            Md5,
+            Sha1,
+            Sha256,
+            Count
+        };
+
+        // load the store from "path" (created on save if it doesn't exist yet)
+        static bool setup(const std::string &path);
+
+        static bool isEnabled();
+
+        // write the store back if it was modified
+        static bool save();
+
+        // returns true if a value exists for "file" and the file didn't change since it was stored
+        static bool get(const std::string &file, Type type, std::string *value);
+
+        static void put(const std::string &file, Type type, const std::string &value);
+    };
+}
+
+#endif //SS_HASHCACHE_H
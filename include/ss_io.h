@@ -7,6 +7,9 @@
 
 #include <string>
 #include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
 
 namespace ss_api {
     class Io {
@@ -15,12 +18,69 @@ namespace ss_api {
         public:
             std::string name;
             std::string path;
-            size_t size;
-            bool isFile;
+            bool isFile = false;
             std::string dc_header_title; // dc
             std::string dc_track01; // dc
+
+            // directory scans don't stat files, the size is fetched (and cached) on first call,
+            // so concurrent first calls on a shared File are not safe
+            size_t getSize() const;
+
+        private:
+            mutable size_t size = 0;
+            mutable bool hasSize = false;
+        };
+
+        // sequential reader of "size" bytes at "offset" (default: whole file), used for hashing and
+        // headers probing. the range is memory mapped with sequential access hints when possible,
+        // and read through a buffer otherwise (small ranges, mmap failure or unsupported platform)
+        class Reader {
+        public:
+            explicit Reader(const std::string &path, uint64_t offset = 0, uint64_t size = UINT64_MAX);
+
+            ~Reader();
+
+            Reader(const Reader &) = delete;
+
+            Reader &operator=(const Reader &) = delete;
+
+            bool isOpen() const { return opened; }
+
+            bool isMapped() const { return map != nullptr; }
+
+            // error while reading (short reads at the end of file are not errors)
+            bool hasError() const { return error; }
+
+            // next chunk of data (zero copy when mapped), false at the end of the range or on error
+            bool next(const unsigned char **data, size_t *size);
+
+            // copy up to "size" bytes to "dst", returns the number of bytes copied
+            size_t read(void *dst, size_t size);
+
+        private:
+            bool next(const unsigned char **data, size_t *size, size_t max);
+
+            bool opened = false;
+            bool error = false;
+            int fd = -1;
+            FILE *file = nullptr;
+            unsigned char *map = nullptr;
+            size_t mapSize = 0;
+            const unsigned char *data = nullptr;
+            uint64_t offset = 0;
+            uint64_t left = 0;
+            std::vector<unsigned char> buffer;
         };
 
+        // called with each file found by walkDir, from the walker threads (must be thread safe)
+        typedef std::function<void(File &&file)> WalkCallback;
+
+        // recursive listing of "path", directories are scanned in parallel by "threads" threads (0: auto).
+        // "maxDepth" limits the recursion (0: "path" only, -1: no limit)
+        static void walkDir(const std::string &path, const std::vector<std::string> &filters,
+                            const WalkCallback &callback, int maxDepth = -1, int threads = 0);
+
+        // recursive lists are sorted by path
         static std::vector<File> getDirList(
                 const std::string &path, bool recursive,
                 const std::vector<std::string> &filters = {".zip"});
@@ -40,6 +100,8 @@ namespace ss_api {
         static std::string toUpper(const std::string &str);
 
         static void delay(int seconds);
+
+        static void delayMs(int ms);
     };
 }
 
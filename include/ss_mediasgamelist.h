@@ -35,10 +35,17 @@ namespace ss_api {
 
         MediasGameList() = default;
 
-        MediasGameList(const std::string &ssid, const std::string &sspassword, int retryDelay = 10);
+        // 429 and timeouts are retried if "retry" (see User)
+        MediasGameList(const std::string &ssid, const std::string &sspassword, bool retry = true);
 
         static bool parseMedia(Media *media, tinyxml2::XMLNode *mediaNode);
 
+        // compact local copy of the list
+        bool save(const std::string &path) const;
+
+        // returns false if "path" doesn't exist or is not valid, "expired" is set if older than "ttl" seconds
+        bool load(const std::string &path, long ttl = 0, bool *expired = nullptr);
+
         std::vector<Media> medias;
         int http_error = 0;
     };
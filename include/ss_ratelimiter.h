@@ -0,0 +1,38 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_RATELIMITER_H
+#define SS_RATELIMITER_H
+
+namespace ss_api {
+
+    class User;
+
+    // process wide api requests limiter (token bucket), shared by all threads and the request engine:
+    // requests are paced to stay under the user "maxrequestspermin", the daily quota is tracked,
+    // and a rate limit error (429) pauses everyone until the server "Retry-After" (plus jitter)
+    class RateLimiter {
+
+    public:
+
+        // configure from user quotas (maxthreads, maxrequestspermin, maxrequestsperday, requeststoday)
+        static void setup(const User &user);
+
+        // "maxRequestsPerMin" <= 0: no pacing, "requestsLeft" < 0: no daily quota
+        static void setup(int maxThreads, int maxRequestsPerMin, long requestsLeft);
+
+        // non blocking, returns 0 if a request can be sent now (and consume a token),
+        // the delay (ms) before retrying otherwise, or -1 if the daily quota is reached
+        static int tryAcquire();
+
+        // blocking, returns false if the daily quota is reached
+        static bool acquire();
+
+        // delay (ms) before retrying a request which failed with "code" (429, timeout...),
+        // "retry" is the retry count (exponential backoff) and "retryAfter" the server hint (seconds)
+        static int getRetryDelay(int code, int retry, long retryAfter = 0);
+    };
+}
+
+#endif //SS_RATELIMITER_H
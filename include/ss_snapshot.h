@@ -0,0 +1,81 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_SNAPSHOT_H
+#define SS_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include "ss_io.h"
+
+// snapshot file name, in the roms folder
+#define SS_SNAPSHOT_FILE ".sscrap_snapshot"
+
+namespace ss_api {
+
+    // listing of a roms folder with files size and mtime, saved between runs to find what changed
+    class Snapshot {
+
+    public:
+
+        struct Entry {
+            std::string name;   // path relative to the roms folder
+            long long size = -1;
+            long long mtime = 0;
+        };
+
+        // names of the files which changed between two snapshots
+        struct Diff {
+            std::vector<std::string> added;
+            std::vector<std::string> removed;
+            std::vector<std::string> modified;
+
+            bool empty() const { return added.empty() && removed.empty() && modified.empty(); }
+        };
+
+        // list "romPath" (see Io::getDirList) and stat the files, "files" receives the listing
+        bool scan(const std::string &romPath, bool recursive,
+                  const std::vector<std::string> &filters, std::vector<Io::File> *files = nullptr);
+
+        // stat "files" again (added or modified) and drop the "removed" entries names
+        void update(const std::string &romPath, const std::vector<Io::File> &files,
+                    const std::vector<std::string> &removed);
+
+        bool load(const std::string &path);
+
+        // if "romPath" is set and its listing didn't change since the scan, the roms folder mtime is
+        // refreshed, so files written by sscrap in the folder (gamelist, hashes) don't invalidate isCurrent
+        bool save(const std::string &path, const std::string &romPath = "") const;
+
+        // files added, removed and modified in "current" since this snapshot
+        Diff diff(const Snapshot &current) const;
+
+        // true if a (non recursive) listing of "romPath" with "filters" would give the same names,
+        // ie: the directory was not modified since the snapshot was taken.
+        // needs nanosecond directory mtimes, always false on other platforms than linux and macos
+        bool isCurrent(const std::string &romPath, bool recursive, const std::vector<std::string> &filters) const;
+
+        // true if "name" is in the snapshot and the file in "romPath" still has the same size and mtime
+        // (already processed, or renamed by sscrap: see Io::getDirList)
+        bool isUnchanged(const std::string &romPath, const std::string &name) const;
+
+        // names of the entries in the sub directory "dir" (relative to the roms folder), recursively
+        std::vector<std::string> getNames(const std::string &dir) const;
+
+        // the snapshot listing, as Io::getDirList would return it (no dreamcast information)
+        std::vector<Io::File> getFiles(const std::string &romPath) const;
+
+        // entry name of a file listed from "romPath"
+        static std::string getName(const std::string &romPath, const Io::File &file);
+
+        bool recursive = false;
+        std::vector<std::string> filters;
+        // roms folder mtime when the snapshot was taken
+        long long mtime = 0;
+        // sorted by name
+        std::vector<Entry> entries;
+    };
+}
+
+#endif //SS_SNAPSHOT_H
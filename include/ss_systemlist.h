@@ -38,7 +38,8 @@ namespace ss_api {
     public:
         SystemList() = default;
 
-        SystemList(const std::string &ssid, const std::string &sspassword, int retryDelay = 10);
+        // 429 and timeouts are retried if "retry" (see User)
+        SystemList(const std::string &ssid, const std::string &sspassword, bool retry = true);
 
         System *find(const System &system);
 
@@ -54,6 +55,12 @@ namespace ss_api {
 
         std::vector<std::string> getNames();
 
+        // compact local copy of the list
+        bool save(const std::string &path) const;
+
+        // returns false if "path" doesn't exist or is not valid, "expired" is set if older than "ttl" seconds
+        bool load(const std::string &path, long ttl = 0, bool *expired = nullptr);
+
         std::vector<System> systems;
 
         static bool parseSystem(System *system, tinyxml2::XMLNode *systemNode);
@@ -15,8 +15,8 @@ namespace ss_api {
 
         User() = default;
 
-        // if retryDelay == 0, disable retry or error
-        User(const std::string &ssid, const std::string &sspassword, int retryDelay = 10);
+        // if retry, requests are retried on 429 or timeout (delay from RateLimiter::getRetryDelay)
+        User(const std::string &ssid, const std::string &sspassword, bool retry = true);
 
         int getMaxThreads();
 
@@ -33,6 +33,7 @@ namespace ss_api {
         std::string maxdownloadspeed;
         std::string requeststoday;
         std::string maxrequestsperday;
+        std::string maxrequestspermin;
         std::string visites;
         std::string datedernierevisite;
         std::string favregion;
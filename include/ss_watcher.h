@@ -0,0 +1,76 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_WATCHER_H
+#define SS_WATCHER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include "ss_snapshot.h"
+
+// a file is reported once it was left untouched for this long (ms)
+#define SS_WATCH_DEBOUNCE_MS 2000
+// changes polling interval, on platforms without inotify (ms)
+#define SS_WATCH_POLL_MS 5000
+
+namespace ss_api {
+
+    // watch a roms folder (inotify on linux, snapshots polling otherwise) for new, changed and removed files
+    class Watcher {
+
+    public:
+
+        struct Changes {
+            // full paths of the files matching the filters
+            std::vector<std::string> changed;
+            // full paths of the files matching the filters, or of sub directories deleted or moved out
+            // (recursive watch), with all their files
+            std::vector<std::string> removed;
+            // some events were lost (inotify queue overflow), the folder should be rescanned
+            bool rescan = false;
+        };
+
+        Watcher(const std::string &path, bool recursive, const std::vector<std::string> &filters,
+                int debounceMs = SS_WATCH_DEBOUNCE_MS);
+
+        ~Watcher();
+
+        Watcher(const Watcher &) = delete;
+
+        Watcher &operator=(const Watcher &) = delete;
+
+        bool start();
+
+        // block until some files changed (and were left untouched for "debounceMs"), false on error
+        bool wait(Changes *changes);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        bool accept(const std::string &name) const;
+
+        std::string path;
+        bool recursive;
+        std::vector<std::string> filters;
+        int debounceMs;
+#ifdef __linux__
+        void addWatch(const std::string &dir, bool notify);
+
+        void removeWatch(const std::string &dir);
+
+        int fd = -1;
+        std::map<int, std::string> watches;
+        // files being written, and the time of their last event
+        std::map<std::string, Clock::time_point> pending;
+        std::vector<std::string> removed;
+        bool overflow = false;
+#else
+        Snapshot snapshot;
+#endif
+    };
+}
+
+#endif //SS_WATCHER_H
@@ -0,0 +1,66 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#ifndef SS_XMLSTREAM_H
+#define SS_XMLSTREAM_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace ss_api {
+
+    // incremental (sax like) xml parser, fed with data chunks as they arrive (curl write callback)
+    class XmlStream {
+
+    public:
+
+        typedef std::vector<std::pair<std::string, std::string>> Attributes;
+
+        virtual ~XmlStream() = default;
+
+        // returns false on syntax error (further data is ignored)
+        bool feed(const char *data, size_t size);
+
+        void reset();
+
+        bool isEmpty() const;
+
+        // true if a root element was fully parsed without error
+        bool isComplete() const;
+
+        bool hasError() const;
+
+        static std::string getAttribute(const Attributes &attributes,
+                                        const std::string &name, const std::string &defaultValue = "");
+
+    protected:
+
+        // element depth, starting at 1 for the root element
+        virtual void onStartElement(const std::string &name, const Attributes &attributes, size_t depth) = 0;
+
+        // "text" is the element text content (not including children text)
+        virtual void onEndElement(const std::string &name, const std::string &text, size_t depth) = 0;
+
+        // name of the element at "depth" (1 = root)
+        const std::string &getElement(size_t depth) const;
+
+    private:
+
+        size_t parse(const char *data, size_t size);
+
+        bool parseTag(const char *data, size_t size);
+
+        void appendText(const char *data, size_t size);
+
+        std::string buffer;
+        std::vector<std::string> elements;
+        std::vector<std::string> texts;
+        bool empty = true;
+        bool complete = false;
+        bool error = false;
+    };
+}
+
+#endif //SS_XMLSTREAM_H
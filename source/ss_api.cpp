@@ -3,14 +3,24 @@
 //
 
 #include <cstdarg>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 #include <zlib.h>
 #include "ss_api.h"
 
 using namespace ss_api;
 
+// files bigger than this are hashed by multiple threads, in SS_CRC_RANGE_SIZE ranges
+#define SS_CRC_PARALLEL_SIZE (64 * 1024 * 1024)
+#define SS_CRC_RANGE_SIZE (16 * 1024 * 1024)
+#define SS_CRC_MAX_THREADS 8
+
 std::string Api::ss_devid;
 std::string Api::ss_devpassword;
 std::string Api::ss_softname;
+std::string Api::ss_baseurl = "https://www.screenscraper.fr/api2/";
 bool ss_debug = false;
 
 std::string
@@ -203,30 +213,88 @@ bool Api::parseBool(const std::string &str, bool defValue) {
     return str == "true" || str == "1";
 }
 
-std::string Api::getFileCrc(const std::string &zipPath) {
-    unsigned char buffer[BUFSIZ];
-    char hex[16];
-    size_t size;
-    FILE *pFile;
+// crc of "size" bytes at "offset" (or up to the end of file), each caller has its own reader.
+// returns the number of bytes read, -1 if the file could not be opened
+static int64_t getRangeCrc(const std::string &path, uint64_t offset, uint64_t size, uint32_t *crc) {
+    *crc = 0;
+
+    Io::Reader reader(path, offset, size);
+    if (!reader.isOpen()) {
+        return -1;
+    }
+
+    const unsigned char *data;
+    size_t len;
+    uint64_t total = 0;
+    while (reader.next(&data, &len)) {
+        *crc = Crc32::update(*crc, data, len);
+        total += len;
+    }
+
+    return reader.hasError() ? -1 : (int64_t) total;
+}
 
+std::string Api::getFileCrc(const std::string &path, int threads) {
+    char hex[16];
     memset(hex, 0, 16);
 
-#ifdef _MSC_VER
-    fopen_s(&pFile, zipPath.c_str(), "rb");
-#else
-    pFile = fopen(zipPath.c_str(), "rb");
-#endif
-    if (!pFile) {
+    std::string cached;
+    if (HashCache::get(path, HashCache::Crc, &cached)) {
+        return cached;
+    }
+
+    uint64_t size = Io::getSize(path);
+    if (threads <= 0) {
+        threads = (int) std::thread::hardware_concurrency();
+    }
+    threads = (int) std::min<uint64_t>((uint64_t) std::max(threads, 1), SS_CRC_MAX_THREADS);
+
+    uint32_t crc = 0;
+    if (threads < 2 || size < SS_CRC_PARALLEL_SIZE) {
+        // small files, or single core: one sequential pass
+        if (getRangeCrc(path, 0, UINT64_MAX, &crc) < 0) {
+            return hex;
+        }
+        snprintf(hex, 16, "%08lx", (unsigned long) crc);
+        HashCache::put(path, HashCache::Crc, hex);
         return hex;
     }
 
-    uLong crc = crc32(0L, Z_NULL, 0);
-    while ((size = fread(buffer, 1, BUFSIZ, pFile)) != 0) {
-        crc = crc32(crc, buffer, size);
+    // split in fixed size ranges, workers pick the next range until all are done
+    size_t count = (size_t) ((size + SS_CRC_RANGE_SIZE - 1) / SS_CRC_RANGE_SIZE);
+    std::vector<uint32_t> crcs(count, 0);
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    auto worker = [&] {
+        size_t i;
+        while (!failed && (i = next++) < count) {
+            uint64_t offset = (uint64_t) i * SS_CRC_RANGE_SIZE;
+            uint64_t len = std::min<uint64_t>(SS_CRC_RANGE_SIZE, size - offset);
+            if (getRangeCrc(path, offset, len, &crcs[i]) != (int64_t) len) {
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads && (size_t) i < count; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &t: workers) {
+        t.join();
+    }
+    if (failed) {
+        return hex;
     }
-    snprintf(hex, 16, "%08lx", crc);
 
-    fclose(pFile);
+    crc = crcs[0];
+    for (size_t i = 1; i < count; i++) {
+        uint64_t len = std::min<uint64_t>(SS_CRC_RANGE_SIZE, size - (uint64_t) i * SS_CRC_RANGE_SIZE);
+        crc = (uint32_t) crc32_combine(crc, crcs[i], (z_off_t) len);
+    }
+    snprintf(hex, 16, "%08lx", (unsigned long) crc);
+    HashCache::put(path, HashCache::Crc, hex);
 
     return hex;
 }
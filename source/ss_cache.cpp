@@ -0,0 +1,176 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <atomic>
+#include <ctime>
+#include <cstdio>
+#include <cinttypes>
+#include <zlib.h>
+#include "ss_api.h"
+#include "ss_cache.h"
+
+using namespace ss_api;
+
+#define SS_CACHE_MAGIC "SSCACHE1"
+
+static std::string cachePath;
+static long cacheTtl = 0;
+static long cacheNegativeTtl = 0;
+static std::atomic<unsigned int> tmpCount(0);
+
+// fnv-1a
+static std::string getHash(const std::string &key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c: key) {
+        hash ^= (unsigned char) c;
+        hash *= 1099511628211ULL;
+    }
+
+    char str[17];
+    snprintf(str, sizeof(str), "%016" PRIx64, hash);
+    return str;
+}
+
+static std::string getPath(const std::string &hash) {
+    return cachePath + "/" + hash.substr(0, 2) + "/" + hash;
+}
+
+void Cache::setup(const std::string &path, long ttl, long negativeTtl) {
+    cachePath = path;
+    cacheTtl = ttl;
+    cacheNegativeTtl = negativeTtl;
+
+    if (!cachePath.empty()) {
+        while (cachePath.size() > 1 && cachePath.back() == '/') {
+            cachePath.pop_back();
+        }
+        if (!Io::exist(cachePath)) {
+            Io::makedir(cachePath);
+        }
+    }
+}
+
+bool Cache::isEnabled() {
+    return !cachePath.empty();
+}
+
+bool Cache::get(const std::string &key, std::string *data, long *code) {
+    if (cachePath.empty()) {
+        return false;
+    }
+
+    FILE *file = fopen(getPath(getHash(key)).c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    std::string buffer;
+    buffer.resize(size > 0 ? (size_t) size : 0);
+    size_t read = buffer.empty() ? 0 : fread(&buffer[0], 1, buffer.size(), file);
+    fclose(file);
+    if (read != buffer.size()) {
+        return false;
+    }
+
+    // header: magic, code, time, size, key
+    size_t line = buffer.find('\n');
+    if (line == std::string::npos) {
+        return false;
+    }
+    char magic[16] = {};
+    long entryCode = 0;
+    long long entryTime = 0;
+    unsigned long entrySize = 0;
+    if (sscanf(buffer.substr(0, line).c_str(), "%15s %li %lld %lu",
+               magic, &entryCode, &entryTime, &entrySize) != 4 || std::string(magic) != SS_CACHE_MAGIC) {
+        return false;
+    }
+    size_t keyEnd = buffer.find('\n', line + 1);
+    if (keyEnd == std::string::npos || buffer.compare(line + 1, keyEnd - line - 1, key) != 0) {
+        // hash collision
+        return false;
+    }
+
+    long ttl = entryCode == 0 ? cacheTtl : cacheNegativeTtl;
+    if (ttl > 0 && (long long) time(nullptr) - entryTime > ttl) {
+        SS_PRINT("Cache::get: expired entry: %s\n", key.c_str());
+        return false;
+    }
+
+    data->clear();
+    if (entrySize > 0) {
+        uLongf dstSize = entrySize;
+        data->resize(entrySize);
+        if (uncompress((Bytef *) &(*data)[0], &dstSize, (const Bytef *) buffer.data() + keyEnd + 1,
+                       (uLong) (buffer.size() - keyEnd - 1)) != Z_OK || dstSize != entrySize) {
+            SS_PRINT("Cache::get: corrupted entry: %s\n", key.c_str());
+            data->clear();
+            return false;
+        }
+    }
+
+    if (code != nullptr) {
+        *code = entryCode;
+    }
+
+    return true;
+}
+
+bool Cache::put(const std::string &key, const std::string &data, long code) {
+    if (cachePath.empty()) {
+        return false;
+    }
+
+    std::string hash = getHash(key);
+    std::string dir = cachePath + "/" + hash.substr(0, 2);
+    if (!Io::exist(dir)) {
+        Io::makedir(dir);
+    }
+
+    std::string compressed;
+    if (!data.empty()) {
+        uLongf size = compressBound((uLong) data.size());
+        compressed.resize(size);
+        if (compress2((Bytef *) &compressed[0], &size,
+                      (const Bytef *) data.data(), (uLong) data.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+            return false;
+        }
+        compressed.resize(size);
+    }
+
+    char header[128];
+    snprintf(header, sizeof(header), "%s %li %lld %lu\n",
+             SS_CACHE_MAGIC, code, (long long) time(nullptr), (unsigned long) data.size());
+
+    // write to a temporary file first, entries are never partially written
+    std::string path = getPath(hash);
+    std::string tmpPath = path + ".tmp" + std::to_string(tmpCount++);
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        SS_PRINT("Cache::put: could not create %s\n", tmpPath.c_str());
+        return false;
+    }
+    bool ok = fputs(header, file) >= 0
+              && fwrite(key.data(), 1, key.size(), file) == key.size()
+              && fputc('\n', file) != EOF
+              && fwrite(compressed.data(), 1, compressed.size(), file) == compressed.size();
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+#ifdef __WINDOWS__
+    remove(path.c_str());
+#endif
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
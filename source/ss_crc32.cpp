@@ -0,0 +1,266 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include "ss_api.h"
+#include "ss_crc32.h"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
+#define SS_CRC32_PCLMUL
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SS_TARGET_PCLMUL
+#else
+#include <cpuid.h>
+#define SS_TARGET_PCLMUL __attribute__((target("sse2,pclmul")))
+#endif
+#endif
+
+#if defined(__aarch64__) && defined(__GNUC__) && (defined(__linux__) || defined(__APPLE__))
+#define SS_CRC32_ARMV8
+#include <arm_acle.h>
+#ifdef __linux__
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+#ifdef __clang__
+#define SS_TARGET_ARMV8 __attribute__((target("crc")))
+#else
+#define SS_TARGET_ARMV8 __attribute__((target("+crc")))
+#endif
+#endif
+
+using namespace ss_api;
+
+typedef uint32_t (*Crc32Func)(uint32_t crc, const unsigned char *buf, size_t len);
+
+//
+// slicing-by-8, portable fallback (and tail bytes of the accelerated versions)
+//
+struct Crc32Tables {
+    uint32_t table[8][256];
+
+    Crc32Tables() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? (c >> 1) ^ 0xedb88320 : c >> 1;
+            }
+            table[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int t = 1; t < 8; t++) {
+                table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+            }
+        }
+    }
+};
+
+static const Crc32Tables &getTables() {
+    static const Crc32Tables tables;
+    return tables;
+}
+
+static inline uint32_t readLe32(const unsigned char *p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// "crc" is the inverted (working) crc value
+static uint32_t crc32Slice8(uint32_t crc, const unsigned char *buf, size_t len) {
+    const Crc32Tables &t = getTables();
+
+    while (len >= 8) {
+        uint32_t lo = readLe32(buf) ^crc;
+        uint32_t hi = readLe32(buf + 4);
+        crc = t.table[7][lo & 0xff] ^ t.table[6][(lo >> 8) & 0xff]
+              ^ t.table[5][(lo >> 16) & 0xff] ^ t.table[4][lo >> 24]
+              ^ t.table[3][hi & 0xff] ^ t.table[2][(hi >> 8) & 0xff]
+              ^ t.table[1][(hi >> 16) & 0xff] ^ t.table[0][hi >> 24];
+        buf += 8;
+        len -= 8;
+    }
+
+    while (len--) {
+        crc = (crc >> 8) ^ t.table[0][(crc ^ *buf++) & 0xff];
+    }
+
+    return crc;
+}
+
+#ifdef SS_CRC32_PCLMUL
+
+// carry-less multiplication folding, see intel "fast crc computation for generic polynomials
+// using pclmulqdq instruction". constants are for the bit-reflected 0x04c11db7 polynomial
+SS_TARGET_PCLMUL
+static uint32_t crc32Pclmul(uint32_t crc, const unsigned char *buf, size_t len) {
+    if (len < 64) {
+        return crc32Slice8(crc, buf, len);
+    }
+
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i *) (buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *) (buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *) (buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *) (buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) crc));
+    buf += 64;
+    len -= 64;
+
+    // fold 4 x 128 bits in parallel
+    x0 = k1k2;
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *) (buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *) (buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *) (buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *) (buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
+
+    // fold into 128 bits
+    x0 = k3k4;
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // remaining 16 bytes blocks
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *) buf)), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    // fold 128 to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // barrett reduction to 32 bits
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    crc = (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+
+    return len > 0 ? crc32Slice8(crc, buf, len) : crc;
+}
+
+static bool hasPclmul() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 1)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL) != 0;
+#endif
+}
+
+#endif
+
+#ifdef SS_CRC32_ARMV8
+
+SS_TARGET_ARMV8
+static uint32_t crc32Armv8(uint32_t crc, const unsigned char *buf, size_t len) {
+    while (len > 0 && ((uintptr_t) buf & 7) != 0) {
+        crc = __crc32b(crc, *buf++);
+        len--;
+    }
+    while (len >= 32) {
+        crc = __crc32d(crc, *(const uint64_t *) (buf + 0));
+        crc = __crc32d(crc, *(const uint64_t *) (buf + 8));
+        crc = __crc32d(crc, *(const uint64_t *) (buf + 16));
+        crc = __crc32d(crc, *(const uint64_t *) (buf + 24));
+        buf += 32;
+        len -= 32;
+    }
+    while (len >= 8) {
+        crc = __crc32d(crc, *(const uint64_t *) buf);
+        buf += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = __crc32b(crc, *buf++);
+    }
+
+    return crc;
+}
+
+static bool hasArmv8Crc() {
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+    return true;
+#else
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+}
+
+#endif
+
+struct Crc32Impl {
+    Crc32Func func = crc32Slice8;
+    const char *name = "slice8";
+
+    Crc32Impl() {
+#ifdef SS_CRC32_PCLMUL
+        if (hasPclmul()) {
+            func = crc32Pclmul;
+            name = "pclmul";
+        }
+#endif
+#ifdef SS_CRC32_ARMV8
+        if (hasArmv8Crc()) {
+            func = crc32Armv8;
+            name = "armv8";
+        }
+#endif
+        SS_PRINT("Crc32: using %s implementation\n", name);
+    }
+};
+
+static const Crc32Impl &getImpl() {
+    static const Crc32Impl impl;
+    return impl;
+}
+
+uint32_t Crc32::update(uint32_t crc, const void *data, size_t size) {
+    if (data == nullptr || size == 0) {
+        return crc;
+    }
+
+    return ~getImpl().func(~crc, (const unsigned char *) data, size);
+}
+
+const char *Crc32::getName() {
+    return getImpl().name;
+}
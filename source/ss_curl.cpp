@@ -2,53 +2,349 @@
 // Created by cpasjuste on 29/03/19.
 //
 
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstring>
+#include <ctime>
+#ifndef _MSC_VER
+#include <strings.h>
+#endif
 #include <curl/curl.h>
 #include "ss_api.h"
 #include "ss_curl.h"
 
 using namespace ss_api;
 
+// connection pool: idle easy handles are kept alive between requests (with their connections), and all of them
+// use the same share handle so dns and tls sessions are reused by every thread
+struct CurlPool {
+    std::mutex mutex;
+    std::mutex locks[CURL_LOCK_DATA_LAST];
+    std::vector<CURL *> handles;
+    CURLSH *share = nullptr;
+};
+
+// never destroyed, worker threads may return their handle after exit() started
+static CurlPool *getPool() {
+    static CurlPool *pool = nullptr;
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        pool = new CurlPool();
+    });
+    return pool;
+}
+
+static void share_lock_cb(CURL * /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void *ptr) {
+    ((CurlPool *) ptr)->locks[data].lock();
+}
+
+static void share_unlock_cb(CURL * /*handle*/, curl_lock_data data, void *ptr) {
+    ((CurlPool *) ptr)->locks[data].unlock();
+}
+
+// one warm handle per thread, given back to the pool when the thread exits
+struct CurlThreadHandle {
+    CURL *handle = nullptr;
+
+    ~CurlThreadHandle() {
+        if (handle != nullptr) {
+            CurlPool *pool = getPool();
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            pool->handles.emplace_back(handle);
+        }
+    }
+};
+
+static thread_local CurlThreadHandle threadHandle;
+
+// response buffer of the current thread
+static thread_local std::string threadBuffer;
+
+// transfers totals
+static std::atomic<size_t> totalWireSize(0);
+static std::atomic<size_t> totalSize(0);
+
+// don't trust the server too much
+#define SS_MAX_RESERVE (32 * 1024 * 1024)
+
 static size_t write_string_cb(void *buf, size_t len, size_t count, void *stream) {
     ((std::string *) stream)->append((char *) buf, 0, len * count);
     return len * count;
 }
 
+static size_t header_cb(char *buf, size_t len, size_t count, void *stream) {
+    auto headers = (Curl::Headers *) stream;
+    size_t size = len * count;
+
+#ifdef _MSC_VER
+    if (size > 5 && _strnicmp(buf, "http/", 5) == 0) {
+#else
+    if (size > 5 && strncasecmp(buf, "http/", 5) == 0) {
+#endif
+        // status line, a new response starts (redirect)
+        headers->contentLength = 0;
+        headers->encoded = false;
+    } else if (size <= 2 && (buf[0] == '\r' || buf[0] == '\n')) {
+        // end of headers, the decoded size is unknown for compressed responses
+        if (headers->data != nullptr && !headers->encoded
+            && headers->contentLength > 0 && headers->contentLength <= SS_MAX_RESERVE) {
+            headers->data->reserve(headers->contentLength);
+        }
+#ifdef _MSC_VER
+    } else if (size > 15 && _strnicmp(buf, "content-length:", 15) == 0) {
+#else
+    } else if (size > 15 && strncasecmp(buf, "content-length:", 15) == 0) {
+#endif
+        headers->contentLength = strtoul(std::string(buf + 15, size - 15).c_str(), nullptr, 10);
+#ifdef _MSC_VER
+    } else if (size > 17 && _strnicmp(buf, "content-encoding:", 17) == 0) {
+#else
+    } else if (size > 17 && strncasecmp(buf, "content-encoding:", 17) == 0) {
+#endif
+        std::string value(buf + 17, size - 17);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r\n") + 1);
+        headers->encoded = !value.empty() && value != "identity";
+#ifdef _MSC_VER
+    } else if (size > 12 && _strnicmp(buf, "retry-after:", 12) == 0) {
+#else
+    } else if (size > 12 && strncasecmp(buf, "retry-after:", 12) == 0) {
+#endif
+        // delay in seconds, or http date
+        std::string value(buf + 12, size - 12);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r\n") + 1);
+        if (!value.empty() && isdigit((unsigned char) value[0])) {
+            headers->retryAfter = strtol(value.c_str(), nullptr, 10);
+        } else if (!value.empty()) {
+            time_t date = curl_getdate(value.c_str(), nullptr);
+            time_t now = time(nullptr);
+            headers->retryAfter = date > now ? (long) (date - now) : 0;
+        }
+    }
+
+    return size;
+}
+
+struct CurlStream {
+    const Curl::StreamCb *cb;
+    size_t size;
+};
+
+static size_t write_stream_cb(void *buf, size_t len, size_t count, void *stream) {
+    auto curlStream = (CurlStream *) stream;
+    curlStream->size += len * count;
+    return (*curlStream->cb)((const char *) buf, len * count) ? len * count : 0;
+}
+
 static size_t write_data_cb(void *buf, size_t len, size_t count, void *stream) {
     size_t written = fwrite(buf, len, count, (FILE *) stream);
     return written;
 }
 
 Curl::Curl() {
-    curl = curl_easy_init();
+    curl = acquire();
 }
 
 Curl::~Curl() {
-    if (curl != nullptr) {
-        curl_easy_cleanup(curl);
+    release(curl);
+}
+
+CURL *Curl::acquire() {
+    CurlPool *pool = getPool();
+    CURL *handle = threadHandle.handle;
+
+    if (handle != nullptr) {
+        threadHandle.handle = nullptr;
+        return handle;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    if (!pool->handles.empty()) {
+        handle = pool->handles.back();
+        pool->handles.pop_back();
+        return handle;
+    }
+
+    if (pool->share == nullptr) {
+        pool->share = curl_share_init();
+        if (pool->share != nullptr) {
+            curl_share_setopt(pool->share, CURLSHOPT_LOCKFUNC, share_lock_cb);
+            curl_share_setopt(pool->share, CURLSHOPT_UNLOCKFUNC, share_unlock_cb);
+            curl_share_setopt(pool->share, CURLSHOPT_USERDATA, pool);
+            curl_share_setopt(pool->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            // connections are not shared: a shared connection cache is not safe with concurrent transfers
+            curl_share_setopt(pool->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        }
+    }
+
+    handle = curl_easy_init();
+    if (handle != nullptr && pool->share != nullptr) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, pool->share);
+    }
+
+    return handle;
+}
+
+void Curl::release(CURL *handle) {
+    if (handle == nullptr) {
+        return;
     }
+
+    // reset options, but keep connections and caches alive
+    CurlPool *pool = getPool();
+    curl_easy_reset(handle);
+    if (pool->share != nullptr) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, pool->share);
+    }
+
+    if (threadHandle.handle == nullptr) {
+        threadHandle.handle = handle;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->handles.emplace_back(handle);
+}
+
+void Curl::cleanup() {
+    CurlPool *pool = getPool();
+
+    if (threadHandle.handle != nullptr) {
+        curl_easy_cleanup(threadHandle.handle);
+        threadHandle.handle = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    for (auto handle: pool->handles) {
+        curl_easy_cleanup(handle);
+    }
+    pool->handles.clear();
+
+    if (pool->share != nullptr) {
+        curl_share_cleanup(pool->share);
+        pool->share = nullptr;
+    }
+}
+
+void Curl::setOptions(CURL *handle, const std::string &url, int timeout) {
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 1);
+    curl_easy_setopt(handle, CURLOPT_FAILONERROR, 1);
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1);
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, false);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, timeout);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    // let the server compress responses, with all encodings supported by libcurl (gzip, brotli, zstd...)
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+}
+
+void Curl::setBuffer(CURL *handle, std::string *data) {
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_string_cb);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, data);
+}
+
+void Curl::setHeaders(CURL *handle, Headers *headers) {
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_cb);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, headers);
+}
+
+std::string &Curl::getBuffer() {
+    return threadBuffer;
+}
+
+Curl::Transfer Curl::getTransfer(CURL *handle, size_t size) {
+    Transfer t;
+#if LIBCURL_VERSION_NUM >= 0x073700
+    curl_off_t wireSize = 0;
+
+    if (curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &wireSize) == CURLE_OK && wireSize > 0) {
+        t.wireSize = (size_t) wireSize;
+    }
+#else
+    double wireSize = 0;
+
+    if (curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD, &wireSize) == CURLE_OK && wireSize > 0) {
+        t.wireSize = (size_t) wireSize;
+    }
+#endif
+    t.size = size;
+
+    totalWireSize += t.wireSize;
+    totalSize += t.size;
+
+    return t;
+}
+
+Curl::Transfer Curl::getTotal() {
+    Transfer t;
+    t.wireSize = totalWireSize;
+    t.size = totalSize;
+    return t;
 }
 
 std::string Curl::getString(const std::string &url, int timeout, long *http_code) {
 
     std::string data;
 
+    getString(url, timeout, http_code, &data);
+
+    return data;
+}
+
+int Curl::getString(const std::string &url, int timeout, long *http_code, std::string *data) {
+
     int res = 0;
 
+    data->clear();
+
+    // let the request engine schedule the request if running (global requests limit),
+    // the response is streamed to "data" so its capacity (per-thread buffer) is kept
+    if (CurlMulti::isRunning()) {
+        CurlMulti::Response response = CurlMulti::getStream(url, timeout, [data](const char *buf, size_t size) {
+            if (buf == nullptr) {
+                data->clear();
+            } else {
+                data->append(buf, size);
+            }
+            return true;
+        }, 0).get();
+        if (http_code != nullptr) {
+            *http_code = response.http_code;
+        }
+        if (response.res != 0) {
+            data->clear();
+        }
+        transfer = response.transfer;
+        retryAfter = response.retryAfter;
+        return response.res;
+    }
+
     if (curl == nullptr) {
         SS_PRINT("Curl::getString: error: curl_easy_init failed\n");
-        return data;
+        return -1;
     }
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_string_cb);
-    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1);
-    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &data);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+    // api request, wait for our turn
+    if (!RateLimiter::acquire()) {
+        SS_PRINT("Curl::getString: error: daily quota reached\n");
+        if (http_code != nullptr) {
+            *http_code = 430;
+        }
+        return -1;
+    }
+
+    Headers headers;
+    headers.data = data;
+    setOptions(curl, url, timeout);
+    setBuffer(curl, data);
+    setHeaders(curl, &headers);
 
     res = curl_easy_perform(curl);
+    transfer = getTransfer(curl, data->size());
+    retryAfter = headers.retryAfter;
     if (http_code != nullptr) {
         curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, http_code);
         if ((*http_code) == 200) {
@@ -60,10 +356,11 @@ std::string Curl::getString(const std::string &url, int timeout, long *http_code
         *http_code = res;
         SS_PRINT("Curl::getString: error: curl_easy_perform failed: %s, http_code: %li\n",
                  curl_easy_strerror((CURLcode) res), http_code ? *http_code : 0);
-        return "";
+        data->clear();
+        return res;
     }
 
-    return data;
+    return 0;
 }
 
 int Curl::getData(const std::string &url, const std::string &dstPath, int timeout, long *http_code) {
@@ -71,6 +368,16 @@ int Curl::getData(const std::string &url, const std::string &dstPath, int timeou
     FILE *data;
     int res = 0;
 
+    if (CurlMulti::isRunning()) {
+        CurlMulti::Response response = CurlMulti::getData(url, dstPath, timeout, 0).get();
+        if (http_code != nullptr) {
+            *http_code = response.http_code;
+        }
+        transfer = response.transfer;
+        retryAfter = response.retryAfter;
+        return response.res;
+    }
+
     if (curl == nullptr) {
         SS_PRINT("Curl::getData: error: curl_easy_init failed\n");
         return -1;
@@ -86,16 +393,15 @@ int Curl::getData(const std::string &url, const std::string &dstPath, int timeou
         return -1;
     }
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    Headers headers;
+    setOptions(curl, url, timeout);
+    setHeaders(curl, &headers);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_data_cb);
-    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1);
-    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, data);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, false);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
 
     res = curl_easy_perform(curl);
+    transfer = getTransfer(curl, (size_t) ftell(data));
+    retryAfter = headers.retryAfter;
     fclose(data);
     if (http_code != nullptr) {
         curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, http_code);
@@ -129,3 +435,58 @@ std::string Curl::escape(const std::string &url) {
 
     return escaped;
 }
+
+int Curl::getStream(const std::string &url, int timeout, long *http_code, const StreamCb &cb) {
+
+    int res = 0;
+
+    if (CurlMulti::isRunning()) {
+        CurlMulti::Response response = CurlMulti::getStream(url, timeout, cb, 0).get();
+        if (http_code != nullptr) {
+            *http_code = response.http_code;
+        }
+        transfer = response.transfer;
+        retryAfter = response.retryAfter;
+        return response.res;
+    }
+
+    if (curl == nullptr) {
+        SS_PRINT("Curl::getStream: error: curl_easy_init failed\n");
+        return -1;
+    }
+
+    // api request, wait for our turn
+    if (!RateLimiter::acquire()) {
+        SS_PRINT("Curl::getStream: error: daily quota reached\n");
+        if (http_code != nullptr) {
+            *http_code = 430;
+        }
+        return -1;
+    }
+
+    Headers headers;
+    CurlStream stream = {&cb, 0};
+    setOptions(curl, url, timeout);
+    setHeaders(curl, &headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_stream_cb);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &stream);
+
+    res = curl_easy_perform(curl);
+    transfer = getTransfer(curl, stream.size);
+    retryAfter = headers.retryAfter;
+    if (http_code != nullptr) {
+        curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, http_code);
+        if ((*http_code) == 200) {
+            (*http_code) = 0;
+        }
+    }
+
+    if (res != 0 && http_code != nullptr && (*http_code) == 0) {
+        *http_code = res;
+        SS_PRINT("Curl::getStream: error: curl_easy_perform failed: %s, http_code: %li\n",
+                 curl_easy_strerror((CURLcode) res), http_code ? *http_code : 0);
+        return res;
+    }
+
+    return 0;
+}
@@ -0,0 +1,398 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <curl/curl.h>
+#include "ss_api.h"
+#include "ss_curlmulti.h"
+
+using namespace ss_api;
+
+typedef std::chrono::steady_clock Clock;
+
+struct CurlRequest {
+    std::string url;
+    std::string dstPath;
+    FILE *file = nullptr;
+    int timeout = SS_TIMEOUT;
+    bool retry = false;
+    int retries = 0;
+    // api request, paced by the rate limiter
+    bool limited = false;
+    Curl::Headers headers;
+    CurlMulti::Callback callback;
+    Curl::StreamCb stream;
+    size_t streamSize = 0;
+    CurlMulti::Response response;
+    CURL *handle = nullptr;
+    Clock::time_point retryAt;
+};
+
+struct CurlEngine {
+    std::mutex mutex;
+    std::thread thread;
+    CURLM *multi = nullptr;
+    std::deque<CurlRequest *> pending;
+    std::vector<CurlRequest *> delayed;
+    int running = 0;
+    int maxRequests = 1;
+    bool started = false;
+    bool stopping = false;
+};
+
+static CurlEngine engine;
+
+static size_t write_stream_cb(void *buf, size_t len, size_t count, void *stream) {
+    auto request = (CurlRequest *) stream;
+    request->streamSize += len * count;
+    return request->stream((const char *) buf, len * count) ? len * count : 0;
+}
+
+static size_t write_data_cb(void *buf, size_t len, size_t count, void *stream) {
+    size_t written = fwrite(buf, len, count, (FILE *) stream);
+    return written;
+}
+
+static void wakeup() {
+#if LIBCURL_VERSION_NUM >= 0x074400
+    if (engine.multi != nullptr) {
+        curl_multi_wakeup(engine.multi);
+    }
+#endif
+}
+
+// called with engine mutex locked
+static bool addRequest(CurlRequest *request) {
+    request->response = {};
+    request->streamSize = 0;
+    request->headers = {};
+    if (!request->dstPath.empty()) {
+#ifdef _MSC_VER
+        fopen_s(&request->file, request->dstPath.c_str(), "wb");
+#else
+        request->file = fopen(request->dstPath.c_str(), "wb");
+#endif
+        if (request->file == nullptr) {
+            SS_PRINT("CurlMulti::getData: error: fopen failed: %s\n", request->dstPath.c_str());
+            request->response.http_code = -1;
+            request->response.res = -1;
+            return false;
+        }
+    }
+
+    request->handle = Curl::acquire();
+    if (request->handle == nullptr) {
+        SS_PRINT("CurlMulti: error: curl_easy_init failed\n");
+        if (request->file != nullptr) {
+            fclose(request->file);
+            request->file = nullptr;
+        }
+        request->response.http_code = -1;
+        request->response.res = -1;
+        return false;
+    }
+
+    Curl::setOptions(request->handle, request->url, request->timeout);
+    Curl::setHeaders(request->handle, &request->headers);
+    if (request->file != nullptr) {
+        curl_easy_setopt(request->handle, CURLOPT_WRITEFUNCTION, write_data_cb);
+        curl_easy_setopt(request->handle, CURLOPT_WRITEDATA, request->file);
+    } else if (request->stream) {
+        curl_easy_setopt(request->handle, CURLOPT_WRITEFUNCTION, write_stream_cb);
+        curl_easy_setopt(request->handle, CURLOPT_WRITEDATA, request);
+    } else {
+        request->headers.data = &request->response.data;
+        Curl::setBuffer(request->handle, &request->response.data);
+    }
+    curl_easy_setopt(request->handle, CURLOPT_PRIVATE, request);
+    curl_multi_add_handle(engine.multi, request->handle);
+    engine.running++;
+
+    return true;
+}
+
+// returns true if the request was re-queued
+static bool finishRequest(CurlRequest *request, CURLcode res) {
+    long http_code = 0;
+
+    curl_easy_getinfo(request->handle, CURLINFO_RESPONSE_CODE, &http_code);
+    if (request->file != nullptr) {
+        request->response.transfer = Curl::getTransfer(request->handle, (size_t) ftell(request->file));
+    } else if (request->stream) {
+        request->response.transfer = Curl::getTransfer(request->handle, request->streamSize);
+    } else {
+        request->response.transfer = Curl::getTransfer(request->handle, request->response.data.size());
+    }
+    curl_multi_remove_handle(engine.multi, request->handle);
+    Curl::release(request->handle);
+    request->handle = nullptr;
+    if (request->file != nullptr) {
+        fclose(request->file);
+        request->file = nullptr;
+    }
+
+    if (http_code == 200) {
+        http_code = 0;
+    }
+    if (res != 0 && http_code == 0) {
+        http_code = res;
+        SS_PRINT("CurlMulti: error: request failed: %s, http_code: %li\n", curl_easy_strerror(res), http_code);
+        request->response.data.clear();
+        if (!request->dstPath.empty()) {
+            remove(request->dstPath.c_str());
+        }
+    }
+    request->response.http_code = http_code;
+    request->response.res = res;
+    request->response.retryAfter = request->headers.retryAfter;
+
+    if (request->retry && (http_code == 429 || http_code == 28)) {
+        int delay = RateLimiter::getRetryDelay((int) http_code, request->retries++, request->headers.retryAfter);
+        Api::printe((int) http_code, (delay + 999) / 1000);
+        if (request->stream) {
+            request->stream(nullptr, 0);
+        }
+        request->retryAt = Clock::now() + std::chrono::milliseconds(delay);
+        std::lock_guard<std::mutex> lock(engine.mutex);
+        engine.delayed.emplace_back(request);
+        engine.running--;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(engine.mutex);
+    engine.running--;
+    return false;
+}
+
+static void engine_thread() {
+    std::vector<CurlRequest *> done;
+
+    while (true) {
+        int waitMs = 100;
+        {
+            std::lock_guard<std::mutex> lock(engine.mutex);
+            if (engine.stopping && engine.running == 0 && engine.pending.empty() && engine.delayed.empty()) {
+                break;
+            }
+
+            // re-queue delayed requests
+            Clock::time_point now = Clock::now();
+            for (size_t i = 0; i < engine.delayed.size();) {
+                CurlRequest *request = engine.delayed.at(i);
+                if (request->retryAt <= now) {
+                    engine.pending.push_front(request);
+                    engine.delayed.erase(engine.delayed.begin() + (long) i);
+                } else {
+                    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(request->retryAt - now);
+                    if (ms.count() < waitMs) waitMs = (int) ms.count() + 1;
+                    i++;
+                }
+            }
+
+            // start queued requests, api requests wait for the rate limiter (medias don't)
+            bool limited = false;
+            for (size_t i = 0; i < engine.pending.size() && engine.running < engine.maxRequests;) {
+                CurlRequest *request = engine.pending.at(i);
+                if (request->limited) {
+                    int delay = limited ? 1 : RateLimiter::tryAcquire();
+                    if (delay > 0) {
+                        if (!limited && delay < waitMs) waitMs = delay;
+                        limited = true;
+                        i++;
+                        continue;
+                    } else if (delay < 0) {
+                        SS_PRINT("CurlMulti: error: daily quota reached (%s)\n", request->url.c_str());
+                        engine.pending.erase(engine.pending.begin() + (long) i);
+                        request->response = {};
+                        request->response.http_code = 430;
+                        request->response.res = -1;
+                        done.emplace_back(request);
+                        continue;
+                    }
+                }
+                engine.pending.erase(engine.pending.begin() + (long) i);
+                if (!addRequest(request)) {
+                    done.emplace_back(request);
+                }
+            }
+        }
+
+        int stillRunning = 0;
+        curl_multi_perform(engine.multi, &stillRunning);
+
+        CURLMsg *msg;
+        int msgsLeft = 0;
+        while ((msg = curl_multi_info_read(engine.multi, &msgsLeft)) != nullptr) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CurlRequest *request = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **) &request);
+            if (request != nullptr && !finishRequest(request, msg->data.result)) {
+                done.emplace_back(request);
+            }
+        }
+
+        // callbacks, without lock held
+        if (!done.empty()) {
+            for (auto request: done) {
+                if (request->callback) {
+                    request->callback(request->response);
+                }
+                delete request;
+            }
+            done.clear();
+            // some slots may be available now
+            continue;
+        }
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+        curl_multi_poll(engine.multi, nullptr, 0, waitMs, nullptr);
+#else
+        if (stillRunning > 0) {
+            curl_multi_wait(engine.multi, nullptr, 0, waitMs, nullptr);
+        } else {
+            // nothing to wait on (curl_multi_wait would return immediately), poll the queue
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+#endif
+    }
+}
+
+static void queueRequest(CurlRequest *request) {
+    {
+        std::lock_guard<std::mutex> lock(engine.mutex);
+        if (engine.started && !engine.stopping) {
+            engine.pending.emplace_back(request);
+            request = nullptr;
+        }
+    }
+
+    if (request != nullptr) {
+        // engine not running
+        SS_PRINT("CurlMulti: error: engine not running, dropping request (%s)\n", request->url.c_str());
+        request->response.http_code = -1;
+        request->response.res = -1;
+        if (request->callback) {
+            request->callback(request->response);
+        }
+        delete request;
+        return;
+    }
+
+    wakeup();
+}
+
+bool CurlMulti::start(int maxRequests) {
+    std::lock_guard<std::mutex> lock(engine.mutex);
+    if (engine.started) {
+        engine.maxRequests = maxRequests > 0 ? maxRequests : 1;
+        return true;
+    }
+
+    // make sure curl global init is done (pool)
+    Curl::release(Curl::acquire());
+
+    engine.multi = curl_multi_init();
+    if (engine.multi == nullptr) {
+        SS_PRINT("CurlMulti::start: error: curl_multi_init failed\n");
+        return false;
+    }
+
+    engine.maxRequests = maxRequests > 0 ? maxRequests : 1;
+    curl_multi_setopt(engine.multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long) engine.maxRequests);
+    engine.stopping = false;
+    engine.started = true;
+    engine.thread = std::thread(engine_thread);
+
+    return true;
+}
+
+void CurlMulti::stop() {
+    {
+        std::lock_guard<std::mutex> lock(engine.mutex);
+        if (!engine.started || engine.stopping) {
+            return;
+        }
+        engine.stopping = true;
+    }
+
+    wakeup();
+    engine.thread.join();
+    curl_multi_cleanup(engine.multi);
+    engine.multi = nullptr;
+
+    std::lock_guard<std::mutex> lock(engine.mutex);
+    engine.started = false;
+    engine.stopping = false;
+}
+
+bool CurlMulti::isRunning() {
+    std::lock_guard<std::mutex> lock(engine.mutex);
+    return engine.started && !engine.stopping;
+}
+
+void CurlMulti::getString(const std::string &url, int timeout, const Callback &cb, bool retry) {
+    auto request = new CurlRequest();
+    request->url = url;
+    request->timeout = timeout;
+    request->retry = retry;
+    request->limited = true;
+    request->callback = cb;
+    queueRequest(request);
+}
+
+void CurlMulti::getData(const std::string &url, const std::string &dstPath,
+                        int timeout, const Callback &cb, bool retry) {
+    auto request = new CurlRequest();
+    request->url = url;
+    request->dstPath = dstPath;
+    request->timeout = timeout;
+    request->retry = retry;
+    request->callback = cb;
+    queueRequest(request);
+}
+
+void CurlMulti::getStream(const std::string &url, int timeout,
+                          const Curl::StreamCb &stream, const Callback &cb, bool retry) {
+    auto request = new CurlRequest();
+    request->url = url;
+    request->timeout = timeout;
+    request->retry = retry;
+    request->limited = true;
+    request->stream = stream;
+    request->callback = cb;
+    queueRequest(request);
+}
+
+std::future<CurlMulti::Response> CurlMulti::getString(const std::string &url, int timeout, bool retry) {
+    auto promise = std::make_shared<std::promise<Response>>();
+    getString(url, timeout, [promise](const Response &response) {
+        promise->set_value(response);
+    }, retry);
+    return promise->get_future();
+}
+
+std::future<CurlMulti::Response> CurlMulti::getData(const std::string &url, const std::string &dstPath,
+                                                    int timeout, bool retry) {
+    auto promise = std::make_shared<std::promise<Response>>();
+    getData(url, dstPath, timeout, [promise](const Response &response) {
+        promise->set_value(response);
+    }, retry);
+    return promise->get_future();
+}
+
+std::future<CurlMulti::Response> CurlMulti::getStream(const std::string &url, int timeout,
+                                                      const Curl::StreamCb &stream, bool retry) {
+    auto promise = std::make_shared<std::promise<Response>>();
+    getStream(url, timeout, stream, [promise](const Response &response) {
+        promise->set_value(response);
+    }, retry);
+    return promise->get_future();
+}
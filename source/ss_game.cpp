@@ -7,7 +7,7 @@
 
 using namespace ss_api;
 
-static int parsePlayerString(const std::string &players) {
+int Game::parsePlayers(const std::string &players) {
     if (players == "1") {
         return 1;
     } else if (players == "1-10") {
@@ -64,7 +64,7 @@ bool Game::isClone() const {
     return !cloneOf.empty() && cloneOf != "0";
 }
 
-int Game::Media::download(const std::string &dstPath, int retryDelay) {
+int Game::Media::download(const std::string &dstPath, bool retry) {
     if (dstPath.empty()) {
         return -1;
     }
@@ -73,10 +73,12 @@ int Game::Media::download(const std::string &dstPath, int retryDelay) {
     long code = 0;
     Curl ss_curl;
     int res = ss_curl.getData(url, dstPath, SS_TIMEOUT, &code);
-    if (retryDelay > 0) {
+    if (retry) {
+        int retries = 0;
         while (code == 429 || code == 28) {
-            Api::printe((int) code, retryDelay);
-            Io::delay(retryDelay);
+            int delay = RateLimiter::getRetryDelay((int) code, retries++, ss_curl.retryAfter);
+            Api::printe((int) code, (delay + 999) / 1000);
+            Io::delayMs(delay);
             res = ss_curl.getData(url, dstPath, SS_TIMEOUT, &code);
         }
     }
@@ -90,6 +92,28 @@ int Game::Media::download(const std::string &dstPath, int retryDelay) {
     return 0;
 }
 
+std::future<int> Game::Media::downloadAsync(const std::string &dstPath, bool retry) {
+    if (dstPath.empty() || !CurlMulti::isRunning()) {
+        std::promise<int> promise;
+        promise.set_value(download(dstPath, retry));
+        return promise.get_future();
+    }
+
+    SS_PRINT("Game::Media::downloadAsync: %s\n", url.c_str());
+    auto promise = std::make_shared<std::promise<int>>();
+    CurlMulti::getData(url, dstPath, SS_TIMEOUT, [promise](const CurlMulti::Response &response) {
+        if (response.res != 0) {
+            SS_PRINT("Game::Media::downloadAsync: error: curl failed: %s, http_code: %li\n",
+                     curl_easy_strerror((CURLcode) response.res), response.http_code);
+            promise->set_value((int) response.http_code);
+        } else {
+            promise->set_value(0);
+        }
+    }, retry);
+
+    return promise->get_future();
+}
+
 bool Game::parseGame(Game *game, tinyxml2::XMLNode *gameNode, const std::string &romName, int format) {
     tinyxml2::XMLElement *element;
 
@@ -299,7 +323,7 @@ bool Game::parseGame(Game *game, tinyxml2::XMLNode *gameNode, const std::string
     } else {
         game->players = Api::getXmlTextStr(gameNode->FirstChildElement("players"), "UNKNOWN");
     }
-    game->playersInt = parsePlayerString(game->players);
+    game->playersInt = parsePlayers(game->players);
 
     // game rotation
     game->rotation = Api::getXmlTextInt(gameNode->FirstChildElement("rotation"));
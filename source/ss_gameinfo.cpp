@@ -2,20 +2,145 @@
 // Created by cpasjuste on 11/12/2019.
 //
 
+#include <memory>
 #include "ss_api.h"
 
 using namespace ss_api;
 
+// returns true if a cached response (or negative entry) was found
+static bool getCached(const std::string &key, GameStream *stream, long *code) {
+    std::string xml;
+
+    if (key.empty() || !Cache::get(key, &xml, code)) {
+        return false;
+    }
+
+    if (*code == 0) {
+        stream->feed(xml.data(), xml.size());
+        if (!stream->isComplete()) {
+            stream->reset();
+            return false;
+        }
+    }
+
+    SS_PRINT("GameInfo: cache hit (%s), code: %li\n", key.c_str(), *code);
+    return true;
+}
+
+// cache found games and "not found" results
+static void putCached(const std::string &key, const std::string &xml, long code, const GameStream &stream) {
+    if (key.empty()) {
+        return;
+    }
+
+    if (code == 0 && stream.isComplete() && !stream.games.empty()) {
+        Cache::put(key, xml);
+    } else if (code == 404) {
+        Cache::put(key, "", code);
+    }
+}
+
 ss_api::GameInfo::GameInfo(const std::string &crc, const std::string &md5, const std::string &sha1,
                            const std::string &systemeid, const std::string &romtype, const std::string &romnom,
                            const std::string &romtaille, const std::string &gameid, const std::string &ssid,
-                           const std::string &sspassword, int retryDelay) {
+                           const std::string &sspassword, bool retry) {
+
+    long code = 0;
+    GameStream stream(romnom);
+    std::string key = getCacheKey(crc, md5, sha1, systemeid, romtype, romnom, gameid);
+    if (getCached(key, &stream, &code)) {
+        parse(stream, code);
+        return;
+    }
+
+    Curl ss_curl;
+    std::string xml;
+    std::string url = getUrl(crc, md5, sha1, systemeid, romtype, romnom, romtaille, gameid, ssid, sspassword);
+
+    SS_PRINT("GameInfo: %s\n", url.c_str());
+
+    // parse the response while it's received (and keep it if cached)
+    Curl::StreamCb cb = [&stream, &xml, &key](const char *data, size_t size) {
+        stream.feed(data, size);
+        if (!key.empty()) {
+            xml.append(data, size);
+        }
+        return true;
+    };
+
+    ss_curl.getStream(url, SS_TIMEOUT, &code, cb);
+    if (retry) {
+        int retries = 0;
+        while (code == 429 || code == 28) {
+            int delay = RateLimiter::getRetryDelay((int) code, retries++, ss_curl.retryAfter);
+            Api::printe((int) code, (delay + 999) / 1000);
+            Io::delayMs(delay);
+            stream.reset();
+            xml.clear();
+            ss_curl.getStream(url, SS_TIMEOUT, &code, cb);
+        }
+    }
+
+    putCached(key, xml, code, stream);
+    parse(stream, code);
+}
+
+void GameInfo::getAsync(const std::string &crc, const std::string &md5, const std::string &sha1,
+                        const std::string &systemeid, const std::string &romtype, const std::string &romnom,
+                        const std::string &romtaille, const std::string &gameid, const std::string &ssid,
+                        const std::string &sspassword, const Callback &cb, bool retry) {
+
+    if (!CurlMulti::isRunning()) {
+        GameInfo gameInfo(crc, md5, sha1, systemeid, romtype, romnom,
+                          romtaille, gameid, ssid, sspassword, retry);
+        if (cb) cb(gameInfo);
+        return;
+    }
 
     long code = 0;
+    auto stream = std::make_shared<GameStream>(romnom);
+    std::string key = getCacheKey(crc, md5, sha1, systemeid, romtype, romnom, gameid);
+    if (getCached(key, stream.get(), &code)) {
+        GameInfo gameInfo;
+        gameInfo.parse(*stream, code);
+        if (cb) cb(gameInfo);
+        return;
+    }
+
+    std::string url = getUrl(crc, md5, sha1, systemeid, romtype, romnom, romtaille, gameid, ssid, sspassword);
+
+    SS_PRINT("GameInfo::getAsync: %s\n", url.c_str());
+
+    auto xml = std::make_shared<std::string>();
+    CurlMulti::getStream(url, SS_TIMEOUT, [stream, xml, key](const char *data, size_t size) {
+        if (data == nullptr) {
+            // request retry
+            stream->reset();
+            xml->clear();
+        } else {
+            stream->feed(data, size);
+            if (!key.empty()) {
+                xml->append(data, size);
+            }
+        }
+        return true;
+    }, [stream, xml, key, cb](const CurlMulti::Response &response) {
+        putCached(key, *xml, response.http_code, *stream);
+        GameInfo gameInfo;
+        gameInfo.parse(*stream, response.http_code);
+        if (cb) cb(gameInfo);
+    }, retry);
+}
+
+std::string GameInfo::getUrl(const std::string &crc, const std::string &md5, const std::string &sha1,
+                             const std::string &systemeid, const std::string &romtype, const std::string &romnom,
+                             const std::string &romtaille, const std::string &gameid, const std::string &ssid,
+                             const std::string &sspassword) {
+
     Curl ss_curl;
     std::string search = ss_curl.escape(romnom);
     std::string soft = ss_curl.escape(Api::ss_softname);
-    std::string url = "https://www.screenscraper.fr/api2/jeuInfos.php?devid="
+    std::string url = Api::ss_baseurl + "jeuInfos.php?devid="
                       + Api::ss_devid + "&devpassword=" + Api::ss_devpassword + "&softname=" + soft + "&output=xml";
 
     url += ssid.empty() ? "" : "&ssid=" + ssid;
@@ -29,44 +154,48 @@ ss_api::GameInfo::GameInfo(const std::string &crc, const std::string &md5, const
     url += gameid.empty() ? "" : "&gameid=" + gameid;
     url += search.empty() ? "" : "&romnom=" + search;
 
-    SS_PRINT("GameInfo: %s\n", url.c_str());
+    return url;
+}
 
-    std::string xml = ss_curl.getString(url, SS_TIMEOUT, &code);
-    if (retryDelay > 0) {
-        while (code == 429 || code == 28) {
-            Api::printe((int) code, retryDelay);
-            Io::delay(retryDelay);
-            xml = ss_curl.getString(url, SS_TIMEOUT, &code);
-        }
+std::string GameInfo::getCacheKey(const std::string &crc, const std::string &md5, const std::string &sha1,
+                                  const std::string &systemeid, const std::string &romtype,
+                                  const std::string &romnom, const std::string &gameid) {
+
+    if (!Cache::isEnabled()) {
+        return "";
     }
 
-    if (code != 0 || xml.empty()) {
+    std::string key = "jeuInfos/" + crc + "/" + md5 + "/" + sha1 + "/" + gameid
+                      + "/" + systemeid + "/" + romtype;
+    // rom name is only part of the key when there is nothing else to identify the game
+    if (crc.empty() && md5.empty() && sha1.empty() && gameid.empty()) {
+        key += "/" + romnom;
+    }
+
+    return key;
+}
+
+void GameInfo::parse(const GameStream &stream, long code) {
+
+    if (code != 0 || stream.isEmpty()) {
         SS_PRINT("GameInfo: error %li\n", code);
         http_error = (int) code;
         return;
     }
 
-    tinyxml2::XMLDocument doc;
-    tinyxml2::XMLError e = doc.Parse(xml.c_str(), xml.size());
-    if (e != tinyxml2::XML_SUCCESS) {
-        SS_PRINT("GameInfo: %s\n", doc.ErrorName());
-        doc.Clear();
+    if (!stream.isComplete()) {
+        SS_PRINT("GameInfo: xml parsing error\n");
         return;
     }
 
-    tinyxml2::XMLNode *pRoot = doc.FirstChildElement("Data");
-    if (pRoot == nullptr) {
+    if (!stream.hasData) {
         SS_PRINT("GameInfo: wrong xml format: \'Data\' tag not found\n");
-        doc.Clear();
         return;
     }
 
-    tinyxml2::XMLNode *gameNode = pRoot->FirstChildElement("jeu");
-    if (gameNode == nullptr) {
+    if (stream.games.empty()) {
         SS_PRINT("GameInfo: wrong xml format: \'jeu\' tag not found\n");
     } else {
-        Game::parseGame(&game, gameNode, romnom, GameList::Format::ScreenScraper);
+        game = stream.games.at(0);
     }
-
-    doc.Clear();
 }
@@ -4,22 +4,128 @@
 
 #include <algorithm>
 #include <cmath>
+#include <unordered_map>
+#include <unordered_set>
 #include "ss_api.h"
 #include "ss_gamelist.h"
 
 using namespace ss_api;
 
+// "next" chains terminator
+#define NO_INDEX ((size_t) -1)
+
+// systems, editors, developers and genres lists: an item is added if neither its id nor its name is listed
+template<typename T>
+class FacetSet {
+public:
+    explicit FacetSet(std::vector<T> *items) : items(items) {
+        for (const auto &item: *items) {
+            ids.insert(item.id);
+            names.insert(item.name);
+        }
+    }
+
+    void add(const T &item) {
+        if (ids.count(item.id) == 0 && names.count(item.name) == 0) {
+            ids.insert(item.id);
+            names.insert(item.name);
+            items->emplace_back(item);
+        }
+    }
+
+private:
+    std::vector<T> *items;
+    std::unordered_set<int> ids;
+    std::unordered_set<std::string> names;
+};
+
+// players, ratings, rotations, resolutions and dates lists
+template<typename T>
+class ValueSet {
+public:
+    explicit ValueSet(std::vector<T> *values) : values(values), seen(values->begin(), values->end()) {}
+
+    void add(const T &value) {
+        if (seen.insert(value).second) {
+            values->emplace_back(value);
+        }
+    }
+
+private:
+    std::vector<T> *values;
+    std::unordered_set<T> seen;
+};
+
+RomFiles::RomFiles(const std::string &rPath, const std::vector<std::string> &filters) : romPath(rPath) {
+    if (!romPath.empty()) {
+        // the folder didn't change since it was scrapped, reuse its listing
+        Snapshot snapshot;
+        if (snapshot.load(romPath + "/" + SS_SNAPSHOT_FILE) && snapshot.isCurrent(romPath, false, filters)) {
+            files = snapshot.getFiles(romPath);
+        } else {
+            files = Io::getDirList(romPath, false, filters);
+        }
+    }
+
+    // files by name
+    matched.assign(files.size(), false);
+    index.reserve(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        index.emplace(files[i].name, i);
+    }
+}
+
+bool RomFiles::match(const std::string &path) {
+    auto it = index.find(path);
+    if (it == index.end() || matched[it->second]) {
+        return false;
+    }
+
+    matched[it->second] = true;
+    return true;
+}
+
+std::vector<Game> RomFiles::getUnmatchedGames(const System &system) const {
+    std::vector<Game> unmatched;
+
+    for (size_t i = 0; i < files.size(); i++) {
+        if (matched[i]) {
+            continue;
+        }
+        Game game;
+        game.id = std::hash<std::string>()(romPath + "/" + files[i].name);
+        game.path = files[i].name;
+        game.romsPath = romPath;
+        game.name = files[i].name;
+        game.available = true;
+        game.system = system;
+        unmatched.emplace_back(game);
+    }
+
+    return unmatched;
+}
+
 bool GameList::append(const std::string &xmlPath, const std::string &rPath,
                       bool sort, const std::vector<std::string> &filters,
                       const System &system, bool availableOnly, const GameAddedCb &cb) {
     tinyxml2::XMLDocument doc;
-    std::vector<Io::File> files;
 
     // add all files first
     if (!rPath.empty()) {
         romPaths.emplace_back(rPath);
-        files = Io::getDirList(rPath, false, filters);
     }
+    RomFiles romFiles(rPath, filters);
+
+    // filtering lists, already listed items are skipped
+    FacetSet<System> systemSet(&systemList.systems);
+    FacetSet<Game::Editor> editorSet(&editors);
+    FacetSet<Game::Developer> developerSet(&developers);
+    FacetSet<Game::Genre> genreSet(&genres);
+    ValueSet<int> playerSet(&players);
+    ValueSet<int> ratingSet(&ratings);
+    ValueSet<int> rotationSet(&rotations);
+    ValueSet<std::string> resolutionSet(&resolutions);
+    ValueSet<std::string> dateSet(&dates);
 
     xml = xmlPath;
     tinyxml2::XMLError e = doc.LoadFile(xmlPath.c_str());
@@ -46,14 +152,9 @@ bool GameList::append(const std::string &xmlPath, const std::string &rPath,
             // set game "real path", minus filename (for pFBN)
             game.romsPath = rPath;
 
-            // is rom available?
-            const std::string n = game.path;
-            auto it = std::find_if(files.begin(), files.end(), [n](const Io::File &f) {
-                return f.name == n;
-            });
-            if (it != files.end()) {
+            // is rom available? (a file is only matched once)
+            if (romFiles.match(game.path)) {
                 game.available = true;
-                files.erase(it);
             } else if (availableOnly) {
                 // move to next node (game)
                 gameNode = gameNode->NextSibling();
@@ -62,63 +163,15 @@ bool GameList::append(const std::string &xmlPath, const std::string &rPath,
 
             // add stuff for later filtering
             if (system.id) game.system = system;
-            System sys1 = game.system;
-            auto itSys = std::find_if(systemList.systems.begin(), systemList.systems.end(), [sys1](const System &sys2) {
-                return sys1.id == sys2.id || sys1.name == sys2.name;
-            });
-            if (itSys == systemList.systems.end()) {
-                systemList.systems.emplace_back(sys1);
-            }
-
-            Game::Editor ed = game.editor.name.empty() ? Game::Editor{0, "UNKNOWN"} : game.editor;
-            auto itEd = std::find_if(editors.begin(), editors.end(), [ed](const Game::Editor &e) {
-                return ed.id == e.id || ed.name == e.name;
-            });
-            if (itEd == editors.end()) {
-                editors.emplace_back(ed);
-            }
-
-            Game::Developer dev = game.developer.name.empty() ? Game::Developer{0, "UNKNOWN"} : game.developer;
-            auto itDev = std::find_if(developers.begin(), developers.end(), [dev](const Game::Developer &d) {
-                return dev.id == d.id || dev.name == d.name;
-            });
-            if (itDev == developers.end()) {
-                developers.emplace_back(dev);
-            }
-
-            Game::Genre genre = game.genre.name.empty() ? Game::Genre{0, "UNKNOWN"} : game.genre;
-            auto itGenre = std::find_if(genres.begin(), genres.end(), [genre](const Game::Genre &g) {
-                return genre.id == g.id || genre.name == g.name;
-            });
-            if (itGenre == genres.end()) {
-                genres.emplace_back(genre);
-            }
-
-            auto itPlayers = std::find(players.begin(), players.end(), game.playersInt);
-            if (itPlayers == players.end()) {
-                players.emplace_back(game.playersInt);
-            }
-
-            auto itRat = std::find(ratings.begin(), ratings.end(), game.rating);
-            if (itRat == ratings.end()) {
-                ratings.emplace_back(game.rating);
-            }
-
-            auto itRot = std::find(rotations.begin(), rotations.end(), game.rotation);
-            if (itRot == rotations.end()) {
-                rotations.emplace_back(game.rotation);
-            }
-
-            std::string resolution = game.resolution.empty() ? "UNKNOWN" : game.resolution;
-            auto it2 = std::find(resolutions.begin(), resolutions.end(), resolution);
-            if (it2 == resolutions.end()) {
-                resolutions.emplace_back(resolution);
-            }
-
-            it2 = std::find(dates.begin(), dates.end(), game.date);
-            if (it2 == dates.end()) {
-                dates.emplace_back(game.date);
-            }
+            systemSet.add(game.system);
+            editorSet.add(game.editor.name.empty() ? Game::Editor{0, "UNKNOWN"} : game.editor);
+            developerSet.add(game.developer.name.empty() ? Game::Developer{0, "UNKNOWN"} : game.developer);
+            genreSet.add(game.genre.name.empty() ? Game::Genre{0, "UNKNOWN"} : game.genre);
+            playerSet.add(game.playersInt);
+            ratingSet.add(game.rating);
+            rotationSet.add(game.rotation);
+            resolutionSet.add(game.resolution.empty() ? "UNKNOWN" : game.resolution);
+            dateSet.add(game.date);
 
             // callback
             if (cb) cb(&game);
@@ -135,21 +188,8 @@ bool GameList::append(const std::string &xmlPath, const std::string &rPath,
     }
 
     // add "unknown" files (not in database)
-    for (const auto &file: files) {
-        Game game;
-        game.id = std::hash<std::string>()(rPath + "/" + file.name);
-        game.path = file.name;
-        game.romsPath = rPath;
-        game.name = file.name;
-        game.available = true;
-        game.system = system;
-        System sys1 = game.system;
-        auto itSys = std::find_if(systemList.systems.begin(), systemList.systems.end(), [sys1](const System &sys2) {
-            return sys1.id == sys2.id || sys1.name == sys2.name;;
-        });
-        if (itSys == systemList.systems.end()) {
-            systemList.systems.emplace_back(sys1);
-        }
+    for (auto &game: romFiles.getUnmatchedGames(system)) {
+        systemSet.add(game.system);
         // callback
         if (cb) cb(&game);
         games.emplace_back(game);
@@ -159,6 +199,9 @@ bool GameList::append(const std::string &xmlPath, const std::string &rPath,
         sortAlpha();
     }
 
+    // built now, so concurrent lookups don't have to
+    updateIndexes();
+
     return true;
 }
 
@@ -169,6 +212,7 @@ void GameList::sortAlpha(bool byZipName, bool gamesOnly) {
     } else {
         std::sort(games.begin(), games.end(), Api::sortGameByName);
     }
+    invalidate();
 
     // sort lists
     if (!gamesOnly) {
@@ -199,6 +243,7 @@ bool GameList::save(const std::string &dstPath, const std::string &imageType,
 
     // sort games
     std::sort(games.begin(), games.end(), Api::sortGameByName);
+    invalidate();
 
     for (const auto &game: games) {
         tinyxml2::XMLElement *gameElement = doc.NewElement("game");
@@ -311,9 +356,9 @@ GameList GameList::filter(bool available, bool clones, int system, int parent_sy
 std::vector<Game> GameList::findGamesByName(const std::string &name) {
     std::vector<Game> matches;
 
-    auto it = std::copy_if(games.begin(), games.end(), std::back_inserter(matches), [name](const Game &game) {
-        return game.name == name;
-    });
+    for (const auto game: getGamesByName(name)) {
+        matches.emplace_back(*game);
+    }
 
     return matches;
 }
@@ -321,9 +366,11 @@ std::vector<Game> GameList::findGamesByName(const std::string &name) {
 std::vector<Game> GameList::findGamesByName(const Game &game) {
     std::vector<Game> matches;
 
-    auto it = std::copy_if(games.begin(), games.end(), std::back_inserter(matches), [game](const Game &g) {
-        return game.name == g.name && game.path != g.path;
-    });
+    for (const auto g: getGamesByName(game.name)) {
+        if (g->path != game.path) {
+            matches.emplace_back(*g);
+        }
+    }
 
     return matches;
 }
@@ -339,39 +386,181 @@ std::vector<Game> GameList::findGamesBySystem(int systemId) {
 }
 
 Game GameList::findGameById(unsigned long id) {
+    Game *game = getGameById(id);
+    return game ? *game : Game();
+}
+
+Game GameList::findGameByPath(const std::string &path) {
+    Game *game = getGameByPath(path);
+    return game ? *game : Game();
+}
+
+Game GameList::findGameByPathAndSystem(const std::string &path, int systemId) {
+    Game *game = getGameByPathAndSystem(path, systemId);
+    return game ? *game : Game();
+}
+
+// link game "i" at the end of "key" chain
+static void appendChain(std::unordered_map<std::string, size_t> *index, std::vector<size_t> *next,
+                        const std::string &key, size_t i) {
+    next->push_back(NO_INDEX);
+    auto it = index->emplace(key, i);
+    if (!it.second) {
+        size_t last = it.first->second;
+        while ((*next)[last] != NO_INDEX) {
+            last = (*next)[last];
+        }
+        (*next)[last] = i;
+    }
+}
+
+void GameList::add(const Game &game) {
+    // indexes are only updated if they were current, else they are rebuilt on next lookup
+    bool current = indexValid && indexData == games.data() && indexSize == games.size();
+    games.emplace_back(game);
+    if (!current) {
+        return;
+    }
+
+    size_t i = games.size() - 1;
+    idIndex.emplace(game.id, i);
+    appendChain(&pathIndex, &nextPath, game.path, i);
+    appendChain(&nameIndex, &nextName, game.name, i);
+    indexData = games.data();
+    indexSize = games.size();
+}
+
+void GameList::invalidate() {
+    indexValid = false;
+}
+
+void GameList::updateIndexes() {
+    if (indexValid && indexData == games.data() && indexSize == games.size()) {
+        return;
+    }
+
+    idIndex.clear();
+    pathIndex.clear();
+    nameIndex.clear();
+    idIndex.reserve(games.size());
+    pathIndex.reserve(games.size());
+    nameIndex.reserve(games.size());
+    nextPath.assign(games.size(), NO_INDEX);
+    nextName.assign(games.size(), NO_INDEX);
+
+    // backward, so keys point to their first game and chains are in "games" order
+    for (size_t i = games.size(); i-- > 0;) {
+        const Game &game = games[i];
+        idIndex[game.id] = i;
+        auto path = pathIndex.emplace(game.path, i);
+        if (!path.second) {
+            nextPath[i] = path.first->second;
+            path.first->second = i;
+        }
+        auto name = nameIndex.emplace(game.name, i);
+        if (!name.second) {
+            nextName[i] = name.first->second;
+            name.first->second = i;
+        }
+    }
+
+    indexData = games.data();
+    indexSize = games.size();
+    indexValid = true;
+}
+
+// the indexes are rebuilt when "games" size or storage changed, which doesn't catch every direct edit
+// (erase then push_back, in place edits): a game not matching its key rebuilds them once, and a key
+// missing from them falls back to a linear search (the indexes are rebuilt on next lookup if found)
+
+Game *GameList::getGameById(unsigned long id) {
+    for (int pass = 0; pass < 2; pass++) {
+        updateIndexes();
+        auto it = idIndex.find(id);
+        if (it == idIndex.end()) {
+            break;
+        }
+        if (games[it->second].id == id) {
+            return &games[it->second];
+        }
+        invalidate();
+    }
+
     auto it = std::find_if(games.begin(), games.end(), [id](const Game &game) {
         return game.id == id;
     });
-
-    if (it != games.end()) {
-        return *it;
+    if (it == games.end()) {
+        return nullptr;
     }
+    invalidate();
 
-    return {};
+    return &*it;
 }
 
-Game GameList::findGameByPath(const std::string &path) {
-    auto it = std::find_if(games.begin(), games.end(), [path](const Game &game) {
-        return game.path == path;
-    });
+Game *GameList::getGameByPath(const std::string &path) {
+    return getGameByPathAndSystem(path, -1);
+}
 
-    if (it != games.end()) {
-        return *it;
+Game *GameList::getGameByPathAndSystem(const std::string &path, int systemId) {
+    for (int pass = 0; pass < 2; pass++) {
+        updateIndexes();
+        auto it = pathIndex.find(path);
+        if (it == pathIndex.end()) {
+            break;
+        }
+        size_t i = it->second;
+        for (; i != NO_INDEX && games[i].path == path; i = nextPath[i]) {
+            if (systemId < 0 || games[i].system.id == systemId) {
+                return &games[i];
+            }
+        }
+        if (i == NO_INDEX) {
+            break;
+        }
+        invalidate();
     }
 
-    return {};
+    auto it = std::find_if(games.begin(), games.end(), [&path, systemId](const Game &game) {
+        return game.path == path && (systemId < 0 || game.system.id == systemId);
+    });
+    if (it == games.end()) {
+        return nullptr;
+    }
+    invalidate();
+
+    return &*it;
 }
 
-Game GameList::findGameByPathAndSystem(const std::string &path, int systemId) {
-    auto it = std::find_if(games.begin(), games.end(), [path, systemId](const Game &game) {
-        return game.system.id == systemId && game.path == path;
-    });
+std::vector<Game *> GameList::getGamesByName(const std::string &name) {
+    std::vector<Game *> matches;
 
-    if (it != games.end()) {
-        return *it;
+    for (int pass = 0; pass < 2; pass++) {
+        updateIndexes();
+        auto it = nameIndex.find(name);
+        if (it == nameIndex.end()) {
+            break;
+        }
+        size_t i = it->second;
+        for (; i != NO_INDEX && games[i].name == name; i = nextName[i]) {
+            matches.emplace_back(&games[i]);
+        }
+        if (i == NO_INDEX) {
+            return matches;
+        }
+        matches.clear();
+        invalidate();
     }
 
-    return {};
+    for (auto &game: games) {
+        if (game.name == name) {
+            matches.emplace_back(&game);
+        }
+    }
+    if (!matches.empty()) {
+        invalidate();
+    }
+
+    return matches;
 }
 
 Game::Editor GameList::findEditorByName(const std::string &name) {
@@ -483,24 +672,19 @@ std::vector<std::string> GameList::getResolutions() {
 }
 
 bool GameList::exist(unsigned long id) {
-    auto it = std::find_if(games.begin(), games.end(), [id](const Game &game) {
-        return game.id == id;
-    });
-
-    return it != games.end();
+    return getGameById(id) != nullptr;
 }
 
 bool GameList::remove(unsigned long id) {
-    auto it = std::find_if(games.begin(), games.end(), [id](const Game &game) {
-        return game.id == id;
-    });
-
-    if (it != games.end()) {
-        games.erase(it);
-        return true;
+    Game *game = getGameById(id);
+    if (game == nullptr) {
+        return false;
     }
 
-    return false;
+    games.erase(games.begin() + (game - games.data()));
+    invalidate();
+
+    return true;
 }
 
 size_t GameList::getAvailableCount(int systemId) {
@@ -0,0 +1,372 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <unordered_set>
+#include "ss_api.h"
+#include "ss_gamestore.h"
+
+using namespace ss_api;
+
+const uint32_t StringPool::npos;
+
+StringPool::StringPool() {
+    strings.emplace_back();
+    ids[""] = 0;
+}
+
+uint32_t StringPool::intern(const std::string &str) {
+    auto it = ids.find(str);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    auto id = (uint32_t) strings.size();
+    strings.emplace_back(str);
+    ids.emplace(str, id);
+
+    return id;
+}
+
+uint32_t StringPool::find(const std::string &str) const {
+    auto it = ids.find(str);
+    return it != ids.end() ? it->second : npos;
+}
+
+size_t StringPool::getMemoryUsage() const {
+    // strings are stored twice (list and map keys), plus map nodes and buckets
+    size_t usage = strings.capacity() * sizeof(std::string) + ids.bucket_count() * sizeof(void *);
+    for (const auto &str: strings) {
+        usage += 2 * (str.size() + 1) + sizeof(std::string) + sizeof(uint32_t) + 2 * sizeof(void *);
+    }
+
+    return usage;
+}
+
+GameStore::GameStore() {
+    clear();
+}
+
+void GameStore::clear() {
+    pool = StringPool();
+    text.assign(1, '\0');
+    for (auto column: {&systemNames, &editorNames, &developerNames, &genreNames, &dates, &resolutions,
+                       &playersNames, &cloneOfs, &romsPaths, &names, &paths, &synopses,
+                       &mediaStarts, &mediaTypes, &mediaFormats, &mediaUrls}) {
+        column->clear();
+    }
+    for (auto column: {&systemIds, &systemParentIds, &editorIds, &developerIds, &genreIds}) {
+        column->clear();
+    }
+    ids.clear();
+    flags.clear();
+    ratings.clear();
+    rotations.clear();
+    players.clear();
+    mediaStarts.push_back(0);
+}
+
+void GameStore::reserve(size_t count) {
+    if (count <= ids.capacity()) {
+        return;
+    }
+
+    for (auto column: {&systemNames, &editorNames, &developerNames, &genreNames, &dates, &resolutions,
+                       &playersNames, &cloneOfs, &romsPaths, &names, &paths, &synopses}) {
+        column->reserve(count);
+    }
+    for (auto column: {&systemIds, &systemParentIds, &editorIds, &developerIds, &genreIds}) {
+        column->reserve(count);
+    }
+    ids.reserve(count);
+    flags.reserve(count);
+    ratings.reserve(count);
+    rotations.reserve(count);
+    players.reserve(count);
+    mediaStarts.reserve(count + 1);
+}
+
+uint32_t GameStore::addText(const std::string &str) {
+    if (str.empty()) {
+        return 0;
+    }
+
+    auto offset = (uint32_t) text.size();
+    text.append(str);
+    text.push_back('\0');
+
+    return offset;
+}
+
+void GameStore::add(const Game &game) {
+    ids.push_back(game.id);
+    flags.push_back((uint8_t) ((game.available ? Available : 0) | (game.isClone() ? Clone : 0)));
+    ratings.push_back((int16_t) game.rating);
+    rotations.push_back((int16_t) game.rotation);
+    players.push_back((int16_t) game.playersInt);
+    systemIds.push_back(game.system.id);
+    systemParentIds.push_back(game.system.parentId);
+    editorIds.push_back(game.editor.id);
+    developerIds.push_back(game.developer.id);
+    genreIds.push_back(game.genre.id);
+    systemNames.push_back(pool.intern(game.system.name));
+    editorNames.push_back(pool.intern(game.editor.name));
+    developerNames.push_back(pool.intern(game.developer.name));
+    genreNames.push_back(pool.intern(game.genre.name));
+    dates.push_back(pool.intern(game.date));
+    resolutions.push_back(pool.intern(game.resolution));
+    playersNames.push_back(pool.intern(game.players));
+    cloneOfs.push_back(pool.intern(game.cloneOf));
+    romsPaths.push_back(pool.intern(game.romsPath));
+    names.push_back(addText(game.name));
+    paths.push_back(addText(game.path));
+    synopses.push_back(addText(game.synopsis));
+
+    for (const auto &media: game.medias) {
+        mediaTypes.push_back(pool.intern(media.type));
+        mediaFormats.push_back(pool.intern(media.format));
+        mediaUrls.push_back(addText(media.url));
+    }
+    mediaStarts.push_back((uint32_t) mediaTypes.size());
+}
+
+Game GameStore::get(size_t row) const {
+    Game game;
+
+    game.id = ids[row];
+    game.available = isAvailable(row);
+    game.rating = ratings[row];
+    game.rotation = rotations[row];
+    game.playersInt = players[row];
+    game.system = System(systemIds[row], systemParentIds[row], pool.get(systemNames[row]));
+    game.editor = Game::Editor(editorIds[row], pool.get(editorNames[row]));
+    game.developer = Game::Developer(developerIds[row], pool.get(developerNames[row]));
+    game.genre = Game::Genre(genreIds[row], pool.get(genreNames[row]));
+    game.date = pool.get(dates[row]);
+    game.resolution = pool.get(resolutions[row]);
+    game.players = pool.get(playersNames[row]);
+    game.cloneOf = pool.get(cloneOfs[row]);
+    game.romsPath = pool.get(romsPaths[row]);
+    game.name = getText(names[row]);
+    game.path = getText(paths[row]);
+    game.synopsis = getText(synopses[row]);
+
+    for (uint32_t i = mediaStarts[row]; i < mediaStarts[row + 1]; i++) {
+        Game::Media media;
+        media.type = pool.get(mediaTypes[i]);
+        media.format = pool.get(mediaFormats[i]);
+        media.url = getText(mediaUrls[i]);
+        game.medias.emplace_back(media);
+    }
+
+    return game;
+}
+
+bool GameStore::append(const std::string &xmlPath, const std::string &romPath,
+                       const std::vector<std::string> &filters, const System &system, bool availableOnly) {
+    tinyxml2::XMLDocument doc;
+    RomFiles romFiles(romPath, filters);
+
+    tinyxml2::XMLError e = doc.LoadFile(xmlPath.c_str());
+    if (e == tinyxml2::XML_SUCCESS) {
+        GameList::Format format = GameList::Format::EmulationStation;
+        tinyxml2::XMLNode *pRoot = doc.FirstChildElement("gameList");
+        if (!pRoot) {
+            pRoot = doc.FirstChildElement("datafile");
+            if (!pRoot) {
+                SS_PRINT("GameStore: wrong xml format: \'gameList\' or \'datafile\' tag not found\n");
+                return false;
+            }
+            format = GameList::Format::FbNeoDat;
+        }
+
+        // columns are sized once (no growth slack)
+        size_t count = 0;
+        for (tinyxml2::XMLNode *gameNode = pRoot->FirstChildElement("game");
+             gameNode; gameNode = gameNode->NextSibling()) {
+            count++;
+        }
+        reserve(size() + count);
+
+        // games are parsed one by one, the xml document is the only full copy in memory
+        for (tinyxml2::XMLNode *gameNode = pRoot->FirstChildElement("game");
+             gameNode; gameNode = gameNode->NextSibling()) {
+            Game game;
+            Game::parseGame(&game, gameNode, "", format);
+            game.romsPath = romPath;
+
+            if (romFiles.match(game.path)) {
+                game.available = true;
+            } else if (availableOnly) {
+                continue;
+            }
+
+            if (system.id) game.system = system;
+            add(game);
+        }
+        doc.Clear();
+    } else {
+        SS_PRINT("GameStore: %s\n", doc.ErrorName());
+    }
+
+    // add "unknown" files (not in database)
+    std::vector<Game> unmatched = romFiles.getUnmatchedGames(system);
+    reserve(size() + unmatched.size());
+    for (const auto &game: unmatched) {
+        add(game);
+        flags.back() |= Unknown;
+    }
+
+    return true;
+}
+
+std::vector<uint32_t> GameStore::filter(bool available, bool clones, int system, int parent_system,
+                                        int editor, int developer, int player, int rating, int rotation, int genre,
+                                        const std::string &resolution, const std::string &date) const {
+    std::vector<uint32_t> rows;
+
+    // strings are compared by pool id, npos (never stored) if the string is unknown
+    bool anyResolution = resolution == "ALL", unknownResolution = resolution == "UNKNOWN";
+    uint32_t resolutionId = pool.find(resolution);
+    bool anyDate = date == "ALL";
+    uint32_t dateId = pool.find(date);
+    uint8_t flagsMask = (uint8_t) ((available ? Available : 0) | (clones ? 0 : Clone));
+    uint8_t flagsValue = (uint8_t) (available ? Available : 0);
+
+    for (size_t row = 0; row < ids.size(); row++) {
+        if ((flags[row] & flagsMask) == flagsValue
+            && (system == -1 || systemIds[row] == system)
+            && (parent_system == -1 || systemParentIds[row] == parent_system)
+            && (editor == -1 || editorIds[row] == editor)
+            && (developer == -1 || developerIds[row] == developer)
+            && (player == -1 || players[row] == player)
+            && (rating == -1 || ratings[row] == rating)
+            && (rotation == -1 || rotations[row] == rotation)
+            && (genre == -1 || genreIds[row] == genre)
+            && (anyResolution || resolutions[row] == resolutionId || (unknownResolution && resolutions[row] == 0))
+            && (anyDate || dates[row] == dateId)) {
+            rows.push_back((uint32_t) row);
+        }
+    }
+
+    return rows;
+}
+
+// systems, editors, developers and genres: an item is listed if neither its id nor its name is listed yet,
+// like GameList. "unknown" files rows are skipped, except for systems
+template<typename T>
+static std::vector<T> getFacets(const std::vector<uint8_t> &flags, uint8_t skipFlags,
+                                const std::vector<int32_t> &ids, const std::vector<uint32_t> &names,
+                                const std::function<T(size_t)> &get) {
+    std::vector<T> facets;
+    std::unordered_set<int32_t> seenIds;
+    std::unordered_set<uint32_t> seenNames;
+
+    for (size_t row = 0; row < ids.size(); row++) {
+        if ((flags[row] & skipFlags) == 0 && seenIds.count(ids[row]) == 0 && seenNames.count(names[row]) == 0) {
+            seenIds.insert(ids[row]);
+            seenNames.insert(names[row]);
+            facets.emplace_back(get(row));
+        }
+    }
+
+    return facets;
+}
+
+// players, ratings, rotations, resolutions and dates
+template<typename T, typename V>
+static std::vector<T> getValues(const std::vector<uint8_t> &flags, uint8_t skipFlags, const std::vector<V> &column,
+                                const std::function<T(V)> &get) {
+    std::vector<T> values;
+    std::unordered_set<V> seen;
+
+    for (size_t row = 0; row < column.size(); row++) {
+        if ((flags[row] & skipFlags) == 0 && seen.insert(column[row]).second) {
+            values.emplace_back(get(column[row]));
+        }
+    }
+
+    return values;
+}
+
+std::vector<System> GameStore::getSystems() const {
+    return getFacets<System>(flags, 0, systemIds, systemNames, [this](size_t row) {
+        return System(systemIds[row], systemParentIds[row], pool.get(systemNames[row]));
+    });
+}
+
+std::vector<Game::Editor> GameStore::getEditors() const {
+    return getFacets<Game::Editor>(flags, Unknown, editorIds, editorNames, [this](size_t row) {
+        return editorNames[row] ? Game::Editor(editorIds[row], pool.get(editorNames[row]))
+                                : Game::Editor(0, "UNKNOWN");
+    });
+}
+
+std::vector<Game::Developer> GameStore::getDevelopers() const {
+    return getFacets<Game::Developer>(flags, Unknown, developerIds, developerNames, [this](size_t row) {
+        return developerNames[row] ? Game::Developer(developerIds[row], pool.get(developerNames[row]))
+                                   : Game::Developer(0, "UNKNOWN");
+    });
+}
+
+std::vector<Game::Genre> GameStore::getGenres() const {
+    return getFacets<Game::Genre>(flags, Unknown, genreIds, genreNames, [this](size_t row) {
+        return genreNames[row] ? Game::Genre(genreIds[row], pool.get(genreNames[row]))
+                               : Game::Genre(0, "UNKNOWN");
+    });
+}
+
+std::vector<int> GameStore::getPlayers() const {
+    return getValues<int, int16_t>(flags, Unknown, players, [](int16_t value) { return (int) value; });
+}
+
+std::vector<int> GameStore::getRatings() const {
+    return getValues<int, int16_t>(flags, Unknown, ratings, [](int16_t value) { return (int) value; });
+}
+
+std::vector<int> GameStore::getRotations() const {
+    return getValues<int, int16_t>(flags, Unknown, rotations, [](int16_t value) { return (int) value; });
+}
+
+std::vector<std::string> GameStore::getResolutions() const {
+    return getValues<std::string, uint32_t>(flags, Unknown, resolutions, [this](uint32_t id) {
+        return id ? pool.get(id) : std::string("UNKNOWN");
+    });
+}
+
+std::vector<std::string> GameStore::getDates() const {
+    return getValues<std::string, uint32_t>(flags, Unknown, dates, [this](uint32_t id) {
+        return pool.get(id);
+    });
+}
+
+static bool lessNoCase(const char *a, const char *b) {
+    for (; *a != '\0' && tolower((unsigned char) *a) == tolower((unsigned char) *b); a++, b++) {}
+    return tolower((unsigned char) *a) < tolower((unsigned char) *b);
+}
+
+void GameStore::sort(std::vector<uint32_t> *rows, bool byPath) const {
+    const std::vector<uint32_t> &column = byPath ? paths : names;
+    std::sort(rows->begin(), rows->end(), [this, &column](uint32_t a, uint32_t b) {
+        return lessNoCase(getText(column[a]), getText(column[b]));
+    });
+}
+
+size_t GameStore::getMemoryUsage() const {
+    size_t usage = pool.getMemoryUsage() + text.capacity()
+                   + ids.capacity() * sizeof(unsigned long) + flags.capacity()
+                   + (ratings.capacity() + rotations.capacity() + players.capacity()) * sizeof(int16_t);
+    for (auto column: {&systemIds, &systemParentIds, &editorIds, &developerIds, &genreIds}) {
+        usage += column->capacity() * sizeof(int32_t);
+    }
+    for (auto column: {&systemNames, &editorNames, &developerNames, &genreNames, &dates, &resolutions,
+                       &playersNames, &cloneOfs, &romsPaths, &names, &paths, &synopses,
+                       &mediaStarts, &mediaTypes, &mediaFormats, &mediaUrls}) {
+        usage += column->capacity() * sizeof(uint32_t);
+    }
+
+    return usage;
+}
@@ -0,0 +1,224 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <algorithm>
+#include "ss_api.h"
+#include "ss_gamestream.h"
+
+using namespace ss_api;
+
+GameStream::GameStream(const std::string &romName) {
+    this->romName = romName;
+}
+
+void GameStream::reset() {
+    XmlStream::reset();
+    games.clear();
+    user = {};
+    hasData = hasUser = hasGames = false;
+    gameDepth = 0;
+    seenElements.clear();
+}
+
+bool GameStream::seen(const std::string &name) {
+    if (std::find(seenElements.begin(), seenElements.end(), name) != seenElements.end()) {
+        return true;
+    }
+
+    seenElements.emplace_back(name);
+    return false;
+}
+
+void GameStream::onStartElement(const std::string &name, const Attributes &attrs, size_t depth) {
+    if (depth == 1) {
+        hasData = name == "Data";
+        return;
+    }
+
+    if (!hasData) {
+        return;
+    }
+
+    // games, "Data/jeu" (jeuInfos, first one only) or "Data/jeux/jeu" (jeuRecherche)
+    if (gameDepth == 0) {
+        bool isGame = name == "jeu"
+                      && ((depth == 2 && games.empty() && !hasGames)
+                          || (depth == 3 && getElement(2) == "jeux" && hasGames));
+        if (depth == 2 && name == "jeux" && !hasGames) {
+            hasGames = true;
+            seenElements.clear();
+        }
+        if (isGame) {
+            game = {};
+            gameDepth = depth;
+            seenElements.clear();
+            firstName.clear(), worName.clear();
+            firstSynopsis.clear(), enSynopsis.clear();
+            firstDate.clear(), worDate.clear();
+            hasFirstName = hasWorName = false;
+            hasFirstSynopsis = hasEnSynopsis = false;
+            hasFirstDate = hasWorDate = false;
+            hasEnGenre = false;
+            isActive = false;
+            game.id = Api::parseULong(getAttribute(attrs, "id"));
+            // system name is empty if "systeme" element is missing
+            game.system.name.clear();
+        }
+        return;
+    }
+
+    size_t level = depth - gameDepth;
+    if (level == 1) {
+        // only the first element of a kind is used (FirstChildElement)
+        isActive = !seen(name);
+        parentAttributes = attrs;
+    } else if (level == 2) {
+        attributes = attrs;
+    }
+}
+
+void GameStream::onEndElement(const std::string &name, const std::string &text, size_t depth) {
+    if (!hasData) {
+        return;
+    }
+
+    // user, "Data/ssuser" (first one only)
+    if (gameDepth == 0) {
+        if (depth == 2 && name == "ssuser") {
+            hasUser = true;
+        } else if (depth == 3 && getElement(2) == "ssuser" && !hasUser) {
+            std::string *field = nullptr;
+            if (name == "id") field = &user.id;
+            else if (name == "niveau") field = &user.niveau;
+            else if (name == "contribution") field = &user.contribution;
+            else if (name == "uploadsysteme") field = &user.uploadsysteme;
+            else if (name == "uploadinfos") field = &user.uploadinfos;
+            else if (name == "romasso") field = &user.romasso;
+            else if (name == "uploadmedia") field = &user.uploadmedia;
+            else if (name == "maxthreads") field = &user.maxthreads;
+            else if (name == "maxdownloadspeed") field = &user.maxdownloadspeed;
+            else if (name == "requeststoday") field = &user.requeststoday;
+            else if (name == "maxrequestsperday") field = &user.maxrequestsperday;
+            else if (name == "maxrequestspermin") field = &user.maxrequestspermin;
+            else if (name == "visites") field = &user.visites;
+            else if (name == "datedernierevisite") field = &user.datedernierevisite;
+            else if (name == "favregion") field = &user.favregion;
+            if (field != nullptr && !seen("ssuser/" + name)) {
+                *field = text;
+            }
+        }
+        return;
+    }
+
+    size_t level = depth - gameDepth;
+    if (level == 0) {
+        // game end
+        if (game.path.empty()) {
+            game.path = romName;
+        }
+        if (game.path.length() > 1 && game.path[0] == '.' && game.path[1] == '/') {
+            game.path = game.path.replace(0, 2, "");
+        }
+        game.name = hasWorName ? worName : "";
+        if (game.name.empty() && hasFirstName) {
+            game.name = firstName;
+        }
+        game.synopsis = hasEnSynopsis ? enSynopsis : "";
+        if (game.synopsis.empty() && hasFirstSynopsis) {
+            game.synopsis = firstSynopsis;
+        }
+        game.date = hasWorDate ? worDate : "";
+        if (game.date.empty() && hasFirstDate) {
+            game.date = firstDate;
+        }
+        if (game.date.size() >= 4) {
+            game.date = game.date.substr(0, 4);
+        } else if (game.date.empty()) {
+            game.date = "UNKNOWN";
+        }
+        game.playersInt = Game::parsePlayers(game.players);
+        games.emplace_back(game);
+        gameDepth = 0;
+        seenElements.clear();
+        return;
+    }
+
+    if (level == 1) {
+        if (!isActive) {
+            return;
+        }
+        isActive = false;
+        if (name == "path") {
+            game.path = text;
+        } else if (name == "cloneof") {
+            game.cloneOf = text;
+        } else if (name == "systeme") {
+            game.system.id = Api::parseInt(getAttribute(parentAttributes, "id"));
+            game.system.parentId = Api::parseInt(getAttribute(parentAttributes, "parentid"));
+            game.system.name = text;
+        } else if (name == "note") {
+            game.rating = Api::parseInt(text);
+        } else if (name == "developpeur") {
+            game.developer.id = Api::parseInt(getAttribute(parentAttributes, "id"));
+            game.developer.name = text.empty() ? "UNKNOWN" : text;
+        } else if (name == "editeur") {
+            game.editor.id = Api::parseInt(getAttribute(parentAttributes, "id"));
+            game.editor.name = text.empty() ? "UNKNOWN" : text;
+        } else if (name == "joueurs") {
+            game.players = text;
+        } else if (name == "rotation") {
+            game.rotation = Api::parseInt(text);
+        } else if (name == "resolution") {
+            game.resolution = text;
+        }
+        return;
+    }
+
+    // only children of the first "noms", "synopsis", "dates", "genres" and "medias" elements
+    if (level != 2 || !isActive) {
+        return;
+    }
+
+    const std::string &parent = getElement(gameDepth + 1);
+
+    if (parent == "noms" && name == "nom") {
+        if (!hasFirstName) {
+            hasFirstName = true;
+            firstName = text;
+        }
+        if (!hasWorName && getAttribute(attributes, "region") == "wor") {
+            hasWorName = true;
+            worName = text;
+        }
+    } else if (parent == "synopsis" && name == "synopsis") {
+        if (!hasFirstSynopsis) {
+            hasFirstSynopsis = true;
+            firstSynopsis = text;
+        }
+        if (!hasEnSynopsis && getAttribute(attributes, "langue") == "en") {
+            hasEnSynopsis = true;
+            enSynopsis = text;
+        }
+    } else if (parent == "dates" && name == "date") {
+        if (!hasFirstDate) {
+            hasFirstDate = true;
+            firstDate = text;
+        }
+        if (!hasWorDate && getAttribute(attributes, "region") == "wor") {
+            hasWorDate = true;
+            worDate = text;
+        }
+    } else if (parent == "genres" && name == "genre") {
+        if (!hasEnGenre && getAttribute(attributes, "langue") == "en") {
+            hasEnGenre = true;
+            game.genre = {Api::parseInt(getAttribute(attributes, "id")), text.empty() ? "UNKNOWN" : text};
+        }
+    } else if (parent == "medias" && name == "media") {
+        std::string region = getAttribute(attributes, "region");
+        std::string type = getAttribute(attributes, "type");
+        if (region == "wor" || type == "video") {
+            game.medias.push_back({text, type, getAttribute(attributes, "format")});
+        }
+    }
+}
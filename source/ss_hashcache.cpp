@@ -0,0 +1,271 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
+#include "ss_api.h"
+#include "ss_hashcache.h"
+
+using namespace ss_api;
+
+#define SS_HASHCACHE_MAGIC "sscrap-hashes"
+#define SS_HASHCACHE_VERSION 3
+
+struct Signature {
+    long long size = -1;
+    long long mtime = 0;
+    long long inode = 0;
+
+    bool operator==(const Signature &other) const {
+        return size == other.size && mtime == other.mtime && inode == other.inode;
+    }
+};
+
+struct HashEntry {
+    Signature signature;
+    std::string values[HashCache::Count];
+};
+
+struct HashStore {
+    std::mutex mutex;
+    std::string path;
+    // the store directory ("" for the current directory), keys are relative to it
+    std::string dir;
+    std::unordered_map<std::string, HashEntry> entries;
+    bool dirty = false;
+};
+
+static HashStore store;
+
+static bool getSignature(const std::string &file, Signature *signature) {
+    struct stat st{};
+    if (stat(file.c_str(), &st) != 0) {
+        return false;
+    }
+
+    signature->size = (long long) st.st_size;
+#if defined(__linux__)
+    signature->mtime = (long long) st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    signature->mtime = (long long) st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    signature->mtime = (long long) st.st_mtime * 1000000000LL;
+#endif
+    signature->inode = (long long) st.st_ino;
+
+    return true;
+}
+
+// "roms//game.zip" and "roms/game.zip" are the same entry
+static std::string normalize(const std::string &file) {
+    std::string path;
+    path.reserve(file.size());
+    for (char c: file) {
+        if (c == '\\') {
+            c = '/';
+        }
+        if (c == '/' && !path.empty() && path.back() == '/') {
+            continue;
+        }
+        path += c;
+    }
+    return path;
+}
+
+static std::string getPrefix() {
+    return store.dir.empty() || store.dir.back() == '/' ? store.dir : store.dir + "/";
+}
+
+// keys are relative to the store directory, so the store is valid whatever the roms path spelling
+// ("roms", "/mnt/roms") or the current directory. files outside of the store directory are not cached
+static bool getKey(const std::string &file, std::string *key) {
+    std::string path = normalize(file);
+    if (store.dir.empty()) {
+        if (path.empty() || path[0] == '/' || (path.size() > 1 && path[1] == ':')) {
+            return false;
+        }
+        *key = path.compare(0, 2, "./") == 0 ? path.substr(2) : path;
+    } else {
+        std::string prefix = getPrefix();
+        if (path.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+        *key = path.substr(prefix.size());
+    }
+
+    return !key->empty();
+}
+
+bool HashCache::setup(const std::string &path) {
+    std::lock_guard<std::mutex> lock(store.mutex);
+    store.path = path;
+    std::string normalized = normalize(path);
+    size_t sep = normalized.rfind('/');
+    store.dir = sep == std::string::npos ? "" : sep == 0 ? "/" : normalized.substr(0, sep);
+    store.entries.clear();
+    store.dirty = false;
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::string data;
+    char buffer[16384];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, read);
+    }
+    fclose(file);
+
+    char magic[32] = {};
+    int version = 0;
+    size_t pos = data.find('\n');
+    if (pos == std::string::npos
+        || sscanf(data.substr(0, pos).c_str(), "%31s %i", magic, &version) != 2
+        || std::string(magic) != SS_HASHCACHE_MAGIC || version < 1 || version > SS_HASHCACHE_VERSION) {
+        SS_PRINT("HashCache::setup: invalid file: %s\n", path.c_str());
+        return false;
+    }
+
+    // size, mtime, inode, crc, rom crc, md5, sha1, sha256 (version 2), path
+    int values = version == 1 ? Sha256 : Count;
+    while (++pos < data.size()) {
+        size_t end = data.find('\n', pos);
+        if (end == std::string::npos) end = data.size();
+        std::string fields[3 + Count];
+        size_t start = pos;
+        int i = 0;
+        for (; i < 3 + values; i++) {
+            size_t tab = data.find('\t', start);
+            if (tab == std::string::npos || tab > end) {
+                break;
+            }
+            fields[i] = data.substr(start, tab - start);
+            start = tab + 1;
+        }
+        pos = end;
+        if (i != 3 + values || start >= end) {
+            continue;
+        }
+        std::string key = data.substr(start, end - start);
+        // version 1 and 2 keys are paths, as given by the caller
+        if (version < 3 && !getKey(key, &key)) {
+            continue;
+        }
+
+        HashEntry entry;
+        entry.signature.size = strtoll(fields[0].c_str(), nullptr, 10);
+        entry.signature.mtime = strtoll(fields[1].c_str(), nullptr, 10);
+        entry.signature.inode = strtoll(fields[2].c_str(), nullptr, 10);
+        for (int t = 0; t < values; t++) {
+            entry.values[t] = fields[3 + t];
+        }
+        store.entries[key] = entry;
+    }
+
+    SS_PRINT("HashCache::setup: %zu entries loaded from %s\n", store.entries.size(), path.c_str());
+
+    return true;
+}
+
+bool HashCache::isEnabled() {
+    std::lock_guard<std::mutex> lock(store.mutex);
+    return !store.path.empty();
+}
+
+bool HashCache::save() {
+    std::lock_guard<std::mutex> lock(store.mutex);
+    if (store.path.empty() || !store.dirty) {
+        return true;
+    }
+
+    std::string tmpPath = store.path + ".tmp";
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        SS_PRINT("HashCache::save: could not create %s\n", tmpPath.c_str());
+        return false;
+    }
+
+    fprintf(file, "%s %i\n", SS_HASHCACHE_MAGIC, SS_HASHCACHE_VERSION);
+    for (const auto &it: store.entries) {
+        // forget deleted files
+        if (!Io::exist(getPrefix() + it.first)) {
+            continue;
+        }
+        const HashEntry &entry = it.second;
+        fprintf(file, "%lld\t%lld\t%lld\t%s\t%s\t%s\t%s\t%s\t%s\n",
+                entry.signature.size, entry.signature.mtime, entry.signature.inode,
+                entry.values[Crc].c_str(), entry.values[RomCrc].c_str(), entry.values[Md5].c_str(),
+                entry.values[Sha1].c_str(), entry.values[Sha256].c_str(), it.first.c_str());
+    }
+
+    if (fclose(file) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+#ifdef __WINDOWS__
+    remove(store.path.c_str());
+#endif
+    if (rename(tmpPath.c_str(), store.path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    store.dirty = false;
+
+    return true;
+}
+
+bool HashCache::get(const std::string &file, Type type, std::string *value) {
+    if (type < 0 || type >= Count || !isEnabled()) {
+        return false;
+    }
+
+    Signature signature;
+    if (!getSignature(file, &signature)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(store.mutex);
+    std::string key;
+    if (!getKey(file, &key)) {
+        return false;
+    }
+    auto it = store.entries.find(key);
+    if (it == store.entries.end() || !(it->second.signature == signature)
+        || it->second.values[type].empty()) {
+        return false;
+    }
+
+    *value = it->second.values[type];
+
+    return true;
+}
+
+void HashCache::put(const std::string &file, Type type, const std::string &value) {
+    // paths are stored one per line
+    if (type < 0 || type >= Count || value.empty() || file.find('\n') != std::string::npos || !isEnabled()) {
+        return;
+    }
+
+    Signature signature;
+    if (!getSignature(file, &signature)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(store.mutex);
+    std::string key;
+    if (!getKey(file, &key)) {
+        return;
+    }
+    HashEntry &entry = store.entries[key];
+    if (!(entry.signature == signature)) {
+        // new or modified file, previous hashes are invalid
+        entry = HashEntry();
+        entry.signature = signature;
+    }
+    entry.values[type] = value;
+    store.dirty = true;
+}
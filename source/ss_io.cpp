@@ -3,9 +3,15 @@
 //
 
 #include <dirent.h>
+#include <ctime>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include "ss_api.h"
 #include "ss_io.h"
 #include "ss_dreamcast.h"
@@ -23,48 +29,61 @@
 #define mkdir(x, y) sceIoMkdir(x, 06)
 #endif
 
+#if !defined(__WINDOWS__) && !defined(__SWITCH__) && !defined(__VITA__) && !defined(__PS4__) && !defined(__3DS__)
+#define SS_IO_MMAP
+#define SS_IO_DIRFD
+#include <fcntl.h>
+#include <sys/mman.h>
+#if defined(__linux__) && defined(STATX_TYPE)
+#define SS_IO_STATX
+#endif
+#endif
+
+// Io::Reader chunk size, and minimum size to memory map a range
+#define SS_IO_CHUNK_SIZE (1024 * 1024)
+#define SS_IO_MMAP_SIZE (256 * 1024)
+
+// Io::walkDir threads, and maximum number of directories kept open in its queues
+#define SS_IO_WALK_MIN_THREADS 4
+#define SS_IO_WALK_MAX_THREADS 16
+#define SS_IO_WALK_MAX_FDS 256
+
 using namespace ss_api;
 
 static std::string dcGetIpHeaderTitle(const std::string &path) {
 
     int offset = 0;
-    char buffer[128];
-
-    FILE *file = fopen(path.c_str(), "rb");
-    if (!file) {
-        //SS_PRINT("dcGetIpHeaderTitle: could not open file: \"%s\"\n", path.c_str());
-        return "";
-    }
+    char buffer[256];
 
     // NO OPT
     if (Io::getExt(path) == "bin") {
         offset = 16;
-        fseek(file, 16, SEEK_SET);
     }
 
-    // read header hardware id (our magic)
-    size_t read = fread(buffer, 1, 15, file);
-    if (read != 15) {
+    Io::Reader reader(path, offset, sizeof(buffer));
+    if (!reader.isOpen()) {
+        //SS_PRINT("dcGetIpHeaderTitle: could not open file: \"%s\"\n", path.c_str());
+        return "";
+    }
+
+    // read header hardware id (our magic) and title
+    size_t read = reader.read(buffer, sizeof(buffer));
+    if (read < 15) {
         SS_PRINT("dcGetIpHeaderTitle: could not read file (1): \"%s\"\n", path.c_str());
-        fclose(file);
         return "";
     }
 
     if (strncmp(buffer, "SEGA SEGAKATANA", 15) != 0) {
         SS_PRINT("dcGetIpHeaderTitle: ip.bin header magic not found (SEGA SEGAKATANA) in \"%s\"\n", path.c_str());
-        fclose(file);
         return "";
     }
 
-    // read header title
-    fseek(file, offset + 128, SEEK_SET);
-    read = fread(buffer, 1, 128, file);
-    if (read != 128) {
+    if (read != sizeof(buffer)) {
         SS_PRINT("dcGetIpHeaderTitle: could not read file (1): \"%s\"\n", path.c_str());
-        fclose(file);
         return "";
     }
-    fclose(file);
+    memmove(buffer, buffer + 128, 128);
+    buffer[128] = '\0';
 
     // trim..
     for (int i = 126; i > 0; i--) {
@@ -83,87 +102,319 @@ static std::string dcGetIpHeaderTitle(const std::string &path) {
     return headerName;
 }
 
-std::vector<Io::File> Io::getDirList(const std::string &path, bool recursive,
-                                     const std::vector<std::string> &filters) {
-    std::vector<Io::File> files;
+// dreamcast title lookup and filters, for a file found in "path". returns false if filtered out
+static bool acceptFile(Io::File &file, const std::string &path, const std::vector<std::string> &filters) {
+    // DC, extract title from track0.bin/iso
+    if (Io::endsWith(file.name, ".gdi", false)) {
+        file.dc_header_title = dcGetIpHeaderTitle(path + "/track01.iso");
+        file.dc_track01 = path + "/track01.iso";
+        if (file.dc_header_title.empty()) {
+            file.dc_header_title = dcGetIpHeaderTitle(path + "/track01.bin");
+            file.dc_track01 = path + "/track01.bin";
+        }
+        if (!file.dc_header_title.empty()) {
+            // rename disc.gdi / disc_optimized.gdi
+            std::string lowerName = Io::toLower(file.name);
+            if (lowerName == "disc.gdi" || lowerName == "disc_optimized.gdi") {
+                std::string newGdiName = Io::toLower(file.dc_header_title) + ".gdi";
+                std::string newPath = path + "/";
+                newPath += newGdiName;
+                if (!rename(file.path.c_str(), newPath.c_str())) {
+                    file.name = newGdiName;
+                    file.path = newPath;
+                }
+            }
+        }
+    }
+
+    if (filters.empty()) {
+        return true;
+    }
+    for (const auto &filter: filters) {
+        if (file.name.find(filter) != std::string::npos) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// a directory to scan. with SS_IO_DIRFD, "fd" is the opened directory (-1: open "path")
+struct DirJob {
+    int fd = -1;
+    std::string path;
+    int depth = 0;
+};
+
+// sub directory found in "dirFd" (-1 without SS_IO_DIRFD)
+typedef std::function<void(int dirFd, const char *name, std::string &&path)> DirCallback;
+
+#ifdef SS_IO_DIRFD
+
+// entry type when readdir doesn't know it (symlinks, some network/fuse filesystems),
+// only the type is requested so the filesystem can answer from its attributes cache
+static bool getEntryType(int dirFd, const char *name, bool *isDir) {
+#ifdef SS_IO_STATX
+    struct statx stx{};
+    if (statx(dirFd, name, AT_STATX_DONT_SYNC, STATX_TYPE, &stx) == 0 && (stx.stx_mask & STATX_TYPE)) {
+        *isDir = S_ISDIR(stx.stx_mode);
+        return true;
+    }
+#endif
     struct stat st{};
+    if (fstatat(dirFd, name, &st, 0) != 0) {
+        return false;
+    }
+    *isDir = S_ISDIR(st.st_mode);
+    return true;
+}
+
+#endif
+
+// list one directory (its fd is closed on return): accepted files are moved to "onFile",
+// sub directories are passed to "onDir" (if not null)
+static void readDir(const DirJob &job, const std::vector<std::string> &filters,
+                    const DirCallback &onDir, const Io::WalkCallback &onFile) {
+#ifdef SS_IO_DIRFD
+    int fd = job.fd >= 0 ? job.fd : open(job.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    DIR *dir = fd >= 0 ? fdopendir(fd) : nullptr;
+    if (dir == nullptr) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+#else
+    DIR *dir = opendir(job.path.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+#endif
+
     struct dirent *ent;
-    DIR *dir;
-
-    if (!path.empty()) {
-        if ((dir = opendir(path.c_str())) != nullptr) {
-            while ((ent = readdir(dir)) != nullptr) {
-                // skip "hidden" files
-                if (ent->d_name[0] == '.') {
-                    continue;
-                }
-#if defined(__SWITCH__) || defined(__VITA__) || defined(__PS4__) || defined(__3DS__)
-                // stat is too slow on switch
-                File file = {ent->d_name, path + "/" + ent->d_name};
-                size_t len = file.name.length();
-                if (len > 3 && (file.name[len - 4] == '.' || file.name[len - 3] == '.')) {
-                    file.isFile = true;
-                } else {
-                    file.isFile = false;
-                }
+    while ((ent = readdir(dir)) != nullptr) {
+        // skip "hidden" files
+        if (ent->d_name[0] == '.') {
+            continue;
+        }
+
+        Io::File file;
+        file.name = ent->d_name;
+        file.path = job.path + "/" + ent->d_name;
+#ifdef SS_IO_DIRFD
+        bool isDir;
+        if (ent->d_type == DT_DIR) {
+            isDir = true;
+        } else if (ent->d_type == DT_REG) {
+            isDir = false;
+        } else if (!getEntryType(dirfd(dir), ent->d_name, &isDir)) {
+            continue;
+        }
+        file.isFile = !isDir;
+#elif defined(__SWITCH__) || defined(__VITA__) || defined(__PS4__) || defined(__3DS__)
+        // stat is too slow on switch
+        size_t len = file.name.length();
+        if (len > 3 && (file.name[len - 4] == '.' || file.name[len - 3] == '.')) {
+            file.isFile = true;
+        } else {
+            file.isFile = false;
+        }
 #else
-                File file = {ent->d_name, path + "/" + ent->d_name};
-                if (stat(file.path.c_str(), &st) == 0) {
-                    file.size = (size_t) st.st_size;
-                    file.isFile = S_ISDIR(st.st_mode) ? false : true;
-                }
+        struct stat st{};
+        if (stat(file.path.c_str(), &st) != 0) {
+            continue;
+        }
+        file.isFile = S_ISDIR(st.st_mode) ? false : true;
 #endif
-                if (!file.isFile) {
-                    if (recursive) {
-                        std::vector<Io::File> subFiles = getDirList(file.path, true, filters);
-                        for (const auto &x: subFiles) {
-                            files.push_back(x);
-                        }
-                    }
-                    continue;
-                }
+        if (!file.isFile) {
+            if (onDir) {
+#ifdef SS_IO_DIRFD
+                onDir(dirfd(dir), ent->d_name, std::move(file.path));
+#else
+                onDir(-1, ent->d_name, std::move(file.path));
+#endif
+            }
+            continue;
+        }
 
-                // DC, extract title from track0.bin/iso
-                if (file.isFile && endsWith(file.name, ".gdi", false)) {
-                    file.dc_header_title = dcGetIpHeaderTitle(path + "/track01.iso");
-                    file.dc_track01 = path + "/track01.iso";
-                    if (file.dc_header_title.empty()) {
-                        file.dc_header_title = dcGetIpHeaderTitle(path + "/track01.bin");
-                        file.dc_track01 = path + "/track01.bin";
-                    }
-                    if (!file.dc_header_title.empty()) {
-                        // rename disc.gdi / disc_optimized.gdi
-                        std::string lowerName = toLower(file.name);
-                        if (lowerName == "disc.gdi" || lowerName == "disc_optimized.gdi") {
-                            std::string newGdiName = toLower(file.dc_header_title) + ".gdi";
-                            std::string newPath = path + "/";
-                            newPath += newGdiName;
-                            if (!rename(file.path.c_str(), newPath.c_str())) {
-                                file.name = newGdiName;
-                                file.path = newPath;
-                            }
-                        }
-                    }
+        if (acceptFile(file, job.path, filters)) {
+            onFile(std::move(file));
+        }
+    }
+
+    closedir(dir);
+}
+
+// work stealing directories walker: each thread pops its own (last pushed, depth first) jobs,
+// and steals the oldest jobs (closest to the root, so the biggest sub trees) of other threads when idle
+class DirWalker {
+public:
+    DirWalker(const std::vector<std::string> &filters, const Io::WalkCallback &callback, int maxDepth, int threads)
+            : filters(filters), callback(callback), maxDepth(maxDepth), queues((size_t) threads) {}
+
+    void run(DirJob &&root) {
+        push(0, std::move(root));
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < queues.size(); i++) {
+            threads.emplace_back(&DirWalker::work, this, (int) i);
+        }
+        work(0);
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<DirJob> jobs;
+    };
+
+    void push(int worker, DirJob &&job) {
+        pending++;
+        queued++;
+        {
+            std::lock_guard<std::mutex> lock(queues[worker].mutex);
+            queues[worker].jobs.push_back(std::move(job));
+        }
+        // synchronize with a thread going to sleep
+        { std::lock_guard<std::mutex> lock(idleMutex); }
+        idle.notify_one();
+    }
+
+    bool pop(int worker, DirJob *job) {
+        {
+            Queue &queue = queues[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                *job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                queued--;
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues.size(); i++) {
+            Queue &queue = queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty()) {
+                *job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                queued--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(int worker) {
+        DirJob job;
+        while (true) {
+            if (!pop(worker, &job)) {
+                std::unique_lock<std::mutex> lock(idleMutex);
+                idle.wait(lock, [this] { return queued > 0 || pending == 0; });
+                if (pending == 0) {
+                    return;
                 }
+                continue;
+            }
 
-                if (!filters.empty()) {
-                    for (const auto &filter: filters) {
-                        if (file.name.find(filter) != std::string::npos) {
-                            files.push_back(file);
-                            break;
-                        }
+            int depth = job.depth;
+            bool recurse = maxDepth < 0 || depth < maxDepth;
+            readDir(job, filters, recurse ? [this, worker, depth](int dirFd, const char *name, std::string &&path) {
+                DirJob sub;
+#ifdef SS_IO_DIRFD
+                // queued jobs keep their directory open, fall back to the path when too many are
+                if (openFds < SS_IO_WALK_MAX_FDS) {
+                    sub.fd = openat(dirFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                    if (sub.fd >= 0) {
+                        openFds++;
                     }
-                } else {
-                    files.push_back(file);
                 }
+#endif
+                sub.path = std::move(path);
+                sub.depth = depth + 1;
+                push(worker, std::move(sub));
+            } : DirCallback(), callback);
+            if (job.fd >= 0) {
+                openFds--;
+            }
+
+            if (--pending == 0) {
+                { std::lock_guard<std::mutex> lock(idleMutex); }
+                idle.notify_all();
             }
-            closedir(dir);
         }
     }
 
+    const std::vector<std::string> &filters;
+    const Io::WalkCallback &callback;
+    int maxDepth;
+    std::vector<Queue> queues;
+    // queued + running jobs
+    std::atomic<int> pending{0};
+    std::atomic<int> queued{0};
+    std::atomic<int> openFds{0};
+    std::mutex idleMutex;
+    std::condition_variable idle;
+};
+
+void Io::walkDir(const std::string &path, const std::vector<std::string> &filters,
+                 const WalkCallback &callback, int maxDepth, int threads) {
+    if (path.empty()) {
+        return;
+    }
+
+    if (threads <= 0) {
+        // directory listing is mostly waiting for the filesystem, use a few threads even on small cpus
+        threads = std::max((int) std::thread::hardware_concurrency(), SS_IO_WALK_MIN_THREADS);
+    }
+    threads = std::min(threads, SS_IO_WALK_MAX_THREADS);
+
+    DirJob root;
+    root.path = path;
+    DirWalker(filters, callback, maxDepth, threads).run(std::move(root));
+}
+
+std::vector<Io::File> Io::getDirList(const std::string &path, bool recursive,
+                                     const std::vector<std::string> &filters) {
+    std::vector<Io::File> files;
+
+    if (path.empty()) {
+        return files;
+    }
+
+    if (!recursive) {
+        DirJob job;
+        job.path = path;
+        readDir(job, filters, DirCallback(), [&files](File &&file) {
+            files.push_back(std::move(file));
+        });
+        return files;
+    }
+
+    std::mutex mutex;
+    walkDir(path, filters, [&files, &mutex](File &&file) {
+        std::lock_guard<std::mutex> lock(mutex);
+        files.push_back(std::move(file));
+    });
+
+    // the walk order depends on threads scheduling
+    std::sort(files.begin(), files.end(), [](const File &a, const File &b) {
+        return a.path < b.path;
+    });
+
     return files;
 }
 
+size_t Io::File::getSize() const {
+    if (!hasSize) {
+        size = Io::getSize(path);
+        hasSize = true;
+    }
+    return size;
+}
+
 void Io::makedir(const std::string &path) {
     mkdir(path.c_str(), 0755);
 }
@@ -228,3 +479,157 @@ void Io::delay(int seconds) {
     sleep(seconds);
 #endif
 }
+
+void Io::delayMs(int ms) {
+    if (ms <= 0) {
+        return;
+    }
+#ifdef __VITA__
+    sceKernelDelayThread(ms * 1000);
+#elif __WINDOWS__
+    Sleep(ms);
+#else
+    struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+    nanosleep(&ts, nullptr);
+#endif
+}
+
+Io::Reader::Reader(const std::string &path, uint64_t offset, uint64_t size) {
+    this->offset = offset;
+    left = size;
+
+#ifdef SS_IO_MMAP
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    opened = true;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || (uint64_t) st.st_size <= offset) {
+        left = 0;
+        return;
+    }
+    left = std::min(left, (uint64_t) st.st_size - offset);
+
+    if (left >= SS_IO_MMAP_SIZE && left <= SIZE_MAX) {
+        // map from the page containing "offset"
+        uint64_t pageSize = (uint64_t) sysconf(_SC_PAGESIZE);
+        uint64_t start = offset - offset % pageSize;
+        size_t length = (size_t) (left + offset - start);
+        void *ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, (off_t) start);
+        if (ptr != MAP_FAILED) {
+            map = (unsigned char *) ptr;
+            mapSize = length;
+            data = map + (offset - start);
+            madvise(map, mapSize, MADV_SEQUENTIAL);
+            madvise(map, mapSize, MADV_WILLNEED);
+            return;
+        }
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, (off_t) offset, (off_t) std::min<uint64_t>(left, INT64_MAX), POSIX_FADV_SEQUENTIAL);
+#endif
+#else
+#ifdef _MSC_VER
+    fopen_s(&file, path.c_str(), "rb");
+#else
+    file = fopen(path.c_str(), "rb");
+#endif
+    if (file == nullptr) {
+        return;
+    }
+    opened = true;
+    setvbuf(file, nullptr, _IONBF, 0);
+#ifdef __WINDOWS__
+    if (_fseeki64(file, (__int64) offset, SEEK_SET) != 0) {
+#else
+    if (fseek(file, (long) offset, SEEK_SET) != 0) {
+#endif
+        left = 0;
+    }
+#endif
+}
+
+Io::Reader::~Reader() {
+#ifdef SS_IO_MMAP
+    if (map != nullptr) {
+        munmap(map, mapSize);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+#else
+    if (file != nullptr) {
+        fclose(file);
+    }
+#endif
+}
+
+bool Io::Reader::next(const unsigned char **data, size_t *size) {
+    return next(data, size, SS_IO_CHUNK_SIZE);
+}
+
+bool Io::Reader::next(const unsigned char **data, size_t *size, size_t max) {
+    if (left == 0 || error) {
+        return false;
+    }
+
+    size_t len = (size_t) std::min<uint64_t>(left, max);
+
+#ifdef SS_IO_MMAP
+    if (map != nullptr) {
+        *data = this->data;
+        *size = len;
+        this->data += len;
+        left -= len;
+        return true;
+    }
+#endif
+
+    if (buffer.size() < len) {
+        buffer.resize(len);
+    }
+
+#ifdef SS_IO_MMAP
+    ssize_t read = pread(fd, buffer.data(), len, (off_t) offset);
+    if (read < 0) {
+        error = true;
+        return false;
+    }
+    size_t count = (size_t) read;
+#else
+    size_t count = fread(buffer.data(), 1, len, file);
+    if (count == 0 && ferror(file)) {
+        error = true;
+        return false;
+    }
+#endif
+    if (count == 0) {
+        // end of file
+        left = 0;
+        return false;
+    }
+
+    offset += count;
+    left -= count;
+    *data = buffer.data();
+    *size = count;
+
+    return true;
+}
+
+size_t Io::Reader::read(void *dst, size_t size) {
+    const unsigned char *chunk;
+    size_t chunkSize, total = 0;
+
+    while (total < size) {
+        if (!next(&chunk, &chunkSize, size - total)) {
+            break;
+        }
+        memcpy((unsigned char *) dst + total, chunk, chunkSize);
+        total += chunkSize;
+    }
+
+    return total;
+}
@@ -2,16 +2,36 @@
 // Created by cpasjuste on 11/12/2019.
 //
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
 #include "ss_api.h"
 
 using namespace ss_api;
 
-MediasGameList::MediasGameList(const std::string &ssid, const std::string &sspassword, int retryDelay) {
+#define SS_MEDIASGAMELIST_MAGIC "sscrap-medias"
+#define SS_MEDIASGAMELIST_VERSION 2
+
+static std::string clean(const std::string &str) {
+    std::string cleaned = str;
+    std::replace(cleaned.begin(), cleaned.end(), '\t', ' ');
+    std::replace(cleaned.begin(), cleaned.end(), '\n', ' ');
+    return cleaned;
+}
+
+// media fields, in file order
+static std::vector<std::string *> getFields(MediasGameList::Media *media) {
+    return {&media->id, &media->name, &media->nameShort, &media->category, &media->platformtypes,
+            &media->plateforms, &media->type, &media->fileformat, &media->fileformat2, &media->autogen,
+            &media->multiregions, &media->multisupports, &media->multiversions, &media->extrainfostxt};
+}
+
+MediasGameList::MediasGameList(const std::string &ssid, const std::string &sspassword, bool retry) {
 
     long code = 0;
     Curl ss_curl;
     std::string soft = ss_curl.escape(Api::ss_softname);
-    std::string url = "https://www.screenscraper.fr/api2/mediasJeuListe.php?devid="
+    std::string url = Api::ss_baseurl + "mediasJeuListe.php?devid="
                       + Api::ss_devid + "&devpassword=" + Api::ss_devpassword
                       + "&softname=" + soft + "&output=xml";
 
@@ -20,12 +40,16 @@ MediasGameList::MediasGameList(const std::string &ssid, const std::string &sspas
 
     SS_PRINT("MediasGameList: %s\n", url.c_str());
 
-    std::string xml = ss_curl.getString(url, SS_TIMEOUT, &code);
-    if (retryDelay > 0) {
+    // reuse this thread response buffer
+    std::string &xml = Curl::getBuffer();
+    ss_curl.getString(url, SS_TIMEOUT, &code, &xml);
+    if (retry) {
+        int retries = 0;
         while (code == 429 || code == 28) {
-            Api::printe((int) code, retryDelay);
-            Io::delay(retryDelay);
-            xml = ss_curl.getString(url, SS_TIMEOUT, &code);
+            int delay = RateLimiter::getRetryDelay((int) code, retries++, ss_curl.retryAfter);
+            Api::printe((int) code, (delay + 999) / 1000);
+            Io::delayMs(delay);
+            ss_curl.getString(url, SS_TIMEOUT, &code, &xml);
         }
     }
 
@@ -91,3 +115,94 @@ bool MediasGameList::parseMedia(Media *media, tinyxml2::XMLNode *mediaNode) {
 
     return true;
 }
+
+bool MediasGameList::save(const std::string &path) const {
+    // written to a temporary file first, a partial list is never left at "path" (interrupted refresh,
+    // concurrent processes: the temporary name is unique)
+    std::string tmpPath = path + ".tmp" + std::to_string(
+            (long long) std::chrono::steady_clock::now().time_since_epoch().count());
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        SS_PRINT("MediasGameList::save: could not create %s\n", tmpPath.c_str());
+        return false;
+    }
+
+    fprintf(file, "%s %i %lld %zu\n", SS_MEDIASGAMELIST_MAGIC, SS_MEDIASGAMELIST_VERSION,
+            (long long) time(nullptr), medias.size());
+    for (auto media: medias) {
+        std::string line;
+        for (auto field: getFields(&media)) {
+            line += (line.empty() ? "" : "\t") + clean(*field);
+        }
+        fprintf(file, "%s\n", line.c_str());
+    }
+
+    if (fclose(file) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+#ifdef __WINDOWS__
+    remove(path.c_str());
+#endif
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool MediasGameList::load(const std::string &path, long ttl, bool *expired) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::string data;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, read);
+    }
+    fclose(file);
+
+    char magic[32] = {};
+    int version = 0;
+    long long date = 0;
+    size_t count = 0;
+    size_t pos = data.find('\n');
+    if (pos == std::string::npos
+        || sscanf(data.substr(0, pos).c_str(), "%31s %i %lld %zu", magic, &version, &date, &count) != 4
+        || std::string(magic) != SS_MEDIASGAMELIST_MAGIC || version != SS_MEDIASGAMELIST_VERSION) {
+        SS_PRINT("MediasGameList::load: invalid file: %s\n", path.c_str());
+        return false;
+    }
+
+    std::vector<Media> list;
+    while (++pos < data.size()) {
+        size_t end = data.find('\n', pos);
+        if (end == std::string::npos) end = data.size();
+        Media media;
+        for (auto field: getFields(&media)) {
+            size_t tab = data.find('\t', pos);
+            size_t next = tab != std::string::npos && tab < end ? tab : end;
+            *field = data.substr(pos, next - pos);
+            pos = next < end ? next + 1 : end;
+        }
+        list.emplace_back(media);
+        pos = end;
+    }
+
+    // truncated file (missing entries, or a partial last one)
+    if (list.size() != count || data.back() != '\n') {
+        SS_PRINT("MediasGameList::load: invalid file: %s\n", path.c_str());
+        return false;
+    }
+
+    medias = list;
+    if (expired != nullptr) {
+        *expired = ttl > 0 && (long long) time(nullptr) - date > ttl;
+    }
+
+    return true;
+}
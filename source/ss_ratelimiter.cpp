@@ -0,0 +1,119 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <mutex>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include "ss_api.h"
+#include "ss_ratelimiter.h"
+
+using namespace ss_api;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Limiter {
+    std::mutex mutex;
+    // tokens per ms, 0 = no pacing
+    double rate = 0;
+    double capacity = 1;
+    double tokens = 1;
+    // daily quota, -1 = unknown
+    long requestsLeft = -1;
+    Clock::time_point last;
+    // all requests are paused until then (429)
+    Clock::time_point cooldown;
+};
+
+static Limiter limiter;
+
+static int getRandom(int max) {
+    static thread_local std::mt19937 rng(std::random_device{}());
+    return max > 0 ? std::uniform_int_distribution<int>(0, max)(rng) : 0;
+}
+
+void RateLimiter::setup(const User &user) {
+    int maxRequestsPerDay = Api::parseInt(user.maxrequestsperday);
+    int requestsToday = Api::parseInt(user.requeststoday);
+    long requestsLeft = maxRequestsPerDay > 0 ? std::max(0, maxRequestsPerDay - requestsToday) : -1;
+
+    setup(Api::parseInt(user.maxthreads, 1), Api::parseInt(user.maxrequestspermin), requestsLeft);
+}
+
+void RateLimiter::setup(int maxThreads, int maxRequestsPerMin, long requestsLeft) {
+    std::lock_guard<std::mutex> lock(limiter.mutex);
+    limiter.rate = maxRequestsPerMin > 0 ? maxRequestsPerMin / 60000.0 : 0;
+    // allow "maxthreads" requests burst
+    limiter.capacity = maxThreads > 0 ? maxThreads : 1;
+    limiter.tokens = limiter.capacity;
+    limiter.requestsLeft = requestsLeft;
+    limiter.last = Clock::now();
+
+    SS_PRINT("RateLimiter: threads: %i, requests per min: %i, requests left: %li\n",
+             maxThreads, maxRequestsPerMin, requestsLeft);
+}
+
+int RateLimiter::tryAcquire() {
+    std::lock_guard<std::mutex> lock(limiter.mutex);
+    Clock::time_point now = Clock::now();
+
+    if (limiter.requestsLeft == 0) {
+        return -1;
+    }
+
+    if (now < limiter.cooldown) {
+        return (int) std::chrono::duration_cast<std::chrono::milliseconds>(limiter.cooldown - now).count() + 1;
+    }
+
+    if (limiter.rate > 0) {
+        double elapsed = std::chrono::duration<double, std::milli>(now - limiter.last).count();
+        limiter.tokens = std::min(limiter.capacity, limiter.tokens + elapsed * limiter.rate);
+        limiter.last = now;
+        if (limiter.tokens < 1) {
+            return (int) ((1 - limiter.tokens) / limiter.rate) + 1;
+        }
+        limiter.tokens -= 1;
+    }
+
+    if (limiter.requestsLeft > 0) {
+        limiter.requestsLeft--;
+    }
+
+    return 0;
+}
+
+bool RateLimiter::acquire() {
+    while (true) {
+        int delay = tryAcquire();
+        if (delay < 0) {
+            return false;
+        } else if (delay == 0) {
+            return true;
+        }
+        Io::delayMs(delay);
+    }
+}
+
+int RateLimiter::getRetryDelay(int code, int retry, long retryAfter) {
+    // exponential backoff (1s to 64s), with jitter so threads don't retry in lockstep
+    int backoff = 1000 << std::min(std::max(retry, 0), 6);
+    int delay = backoff / 2 + getRandom(backoff / 2);
+    if (retryAfter > 0) {
+        delay = std::max(delay, (int) std::min(retryAfter, 3600L) * 1000 + getRandom(1000));
+    }
+
+    if (code == 429) {
+        // pause all requests, the server says we are too fast
+        std::lock_guard<std::mutex> lock(limiter.mutex);
+        Clock::time_point now = Clock::now();
+        Clock::time_point until = now + std::chrono::milliseconds(delay);
+        if (until > limiter.cooldown) {
+            limiter.cooldown = until;
+        }
+        limiter.tokens = 0;
+        limiter.last = now;
+    }
+
+    return delay;
+}
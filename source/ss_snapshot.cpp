@@ -0,0 +1,289 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <algorithm>
+#include <sys/stat.h>
+#include "ss_api.h"
+#include "ss_snapshot.h"
+
+using namespace ss_api;
+
+#define SS_SNAPSHOT_MAGIC "sscrap-snapshot"
+#define SS_SNAPSHOT_VERSION 1
+
+static bool getStat(const std::string &path, long long *size, long long *mtime) {
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+
+    if (size != nullptr) {
+        *size = (long long) st.st_size;
+    }
+#if defined(__linux__)
+    *mtime = (long long) st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+    *mtime = (long long) st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    *mtime = (long long) st.st_mtime * 1000000000LL;
+#endif
+
+    return true;
+}
+
+static bool sortByName(const Snapshot::Entry &a, const Snapshot::Entry &b) {
+    return a.name < b.name;
+}
+
+bool Snapshot::scan(const std::string &romPath, bool rec,
+                    const std::vector<std::string> &flt, std::vector<Io::File> *files) {
+    recursive = rec;
+    filters = flt;
+    entries.clear();
+
+    // taken before the listing: a file added during the scan makes the next isCurrent() fail
+    if (!getStat(romPath, nullptr, &mtime)) {
+        return false;
+    }
+
+    std::vector<Io::File> list = Io::getDirList(romPath, recursive, filters);
+    entries.reserve(list.size());
+    for (const auto &file: list) {
+        Entry entry;
+        entry.name = getName(romPath, file);
+        if (getStat(file.path, &entry.size, &entry.mtime)) {
+            entries.push_back(std::move(entry));
+        }
+    }
+    std::sort(entries.begin(), entries.end(), sortByName);
+
+    if (files != nullptr) {
+        *files = std::move(list);
+    }
+
+    return true;
+}
+
+void Snapshot::update(const std::string &romPath, const std::vector<Io::File> &files,
+                      const std::vector<std::string> &removed) {
+    for (const auto &name: removed) {
+        Entry entry;
+        entry.name = name;
+        auto it = std::lower_bound(entries.begin(), entries.end(), entry, sortByName);
+        if (it != entries.end() && it->name == name) {
+            entries.erase(it);
+        }
+    }
+
+    for (const auto &file: files) {
+        Entry entry;
+        entry.name = getName(romPath, file);
+        if (!getStat(file.path, &entry.size, &entry.mtime)) {
+            continue;
+        }
+        auto it = std::lower_bound(entries.begin(), entries.end(), entry, sortByName);
+        if (it != entries.end() && it->name == entry.name) {
+            *it = std::move(entry);
+        } else {
+            entries.insert(it, std::move(entry));
+        }
+    }
+}
+
+bool Snapshot::load(const std::string &path) {
+    entries.clear();
+    filters.clear();
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::string data;
+    char buffer[16384];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, read);
+    }
+    fclose(file);
+
+    // header: magic, version, recursive, roms folder mtime, then the filters line
+    char magic[32] = {};
+    int version = 0, rec = 0;
+    size_t pos = data.find('\n');
+    if (pos == std::string::npos
+        || sscanf(data.substr(0, pos).c_str(), "%31s %i %i %lld", magic, &version, &rec, &mtime) != 4
+        || std::string(magic) != SS_SNAPSHOT_MAGIC || version != SS_SNAPSHOT_VERSION) {
+        SS_PRINT("Snapshot::load: invalid file: %s\n", path.c_str());
+        return false;
+    }
+    recursive = rec != 0;
+
+    size_t end = data.find('\n', pos + 1);
+    if (end == std::string::npos) {
+        return false;
+    }
+    for (size_t start = pos + 1; start < end;) {
+        size_t tab = std::min(data.find('\t', start), end);
+        filters.push_back(data.substr(start, tab - start));
+        start = tab + 1;
+    }
+    pos = end;
+
+    // size, mtime, name
+    while (++pos < data.size()) {
+        end = data.find('\n', pos);
+        if (end == std::string::npos) end = data.size();
+        size_t tab1 = data.find('\t', pos);
+        size_t tab2 = tab1 == std::string::npos ? tab1 : data.find('\t', tab1 + 1);
+        if (tab2 == std::string::npos || tab2 >= end) {
+            pos = end;
+            continue;
+        }
+        Entry entry;
+        entry.size = strtoll(data.c_str() + pos, nullptr, 10);
+        entry.mtime = strtoll(data.c_str() + tab1 + 1, nullptr, 10);
+        entry.name = data.substr(tab2 + 1, end - tab2 - 1);
+        entries.push_back(std::move(entry));
+        pos = end;
+    }
+    std::sort(entries.begin(), entries.end(), sortByName);
+
+    SS_PRINT("Snapshot::load: %zu entries loaded from %s\n", entries.size(), path.c_str());
+
+    return true;
+}
+
+bool Snapshot::save(const std::string &path, const std::string &romPath) const {
+    long long folderMtime = mtime;
+
+    // the file is rewritten in place (no rename), so only its creation changes the roms folder mtime
+    if (!romPath.empty() && !recursive) {
+        if (!Io::exist(path)) {
+            FILE *file = fopen(path.c_str(), "wb");
+            if (file != nullptr) {
+                fclose(file);
+            }
+        }
+        std::vector<Io::File> files = Io::getDirList(romPath, false, filters);
+        bool unchanged = files.size() == entries.size();
+        for (const auto &file: files) {
+            Entry entry;
+            entry.name = file.name;
+            unchanged = unchanged && std::binary_search(entries.begin(), entries.end(), entry, sortByName);
+        }
+        if (unchanged) {
+            getStat(romPath, nullptr, &folderMtime);
+        }
+    }
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        SS_PRINT("Snapshot::save: could not create %s\n", path.c_str());
+        return false;
+    }
+
+    // a partially written snapshot only causes unchanged files to be seen as added
+    fprintf(file, "%s %i %i %lld\n", SS_SNAPSHOT_MAGIC, SS_SNAPSHOT_VERSION, recursive ? 1 : 0, folderMtime);
+    for (size_t i = 0; i < filters.size(); i++) {
+        fprintf(file, i > 0 ? "\t%s" : "%s", filters[i].c_str());
+    }
+    fputc('\n', file);
+    for (const auto &entry: entries) {
+        fprintf(file, "%lld\t%lld\t%s\n", entry.size, entry.mtime, entry.name.c_str());
+    }
+
+    return fclose(file) == 0;
+}
+
+Snapshot::Diff Snapshot::diff(const Snapshot &current) const {
+    Diff diff;
+
+    // both lists are sorted by name
+    auto a = entries.begin();
+    auto b = current.entries.begin();
+    while (a != entries.end() || b != current.entries.end()) {
+        if (b == current.entries.end() || (a != entries.end() && a->name < b->name)) {
+            diff.removed.push_back(a->name);
+            ++a;
+        } else if (a == entries.end() || b->name < a->name) {
+            diff.added.push_back(b->name);
+            ++b;
+        } else {
+            if (a->size != b->size || a->mtime != b->mtime) {
+                diff.modified.push_back(b->name);
+            }
+            ++a;
+            ++b;
+        }
+    }
+
+    return diff;
+}
+
+bool Snapshot::isCurrent(const std::string &romPath, bool rec, const std::vector<std::string> &flt) const {
+#if defined(__linux__) || defined(__APPLE__)
+    // sub directories changes don't update the roms folder mtime
+    if (rec || recursive || flt != filters) {
+        return false;
+    }
+
+    long long current;
+    return getStat(romPath, nullptr, &current) && current == mtime;
+#else
+    // second resolution mtime: a file added in the same second as the scan would be missed
+    (void) romPath;
+    (void) rec;
+    (void) flt;
+    return false;
+#endif
+}
+
+bool Snapshot::isUnchanged(const std::string &romPath, const std::string &name) const {
+    Entry entry;
+    entry.name = name;
+    auto it = std::lower_bound(entries.begin(), entries.end(), entry, sortByName);
+    if (it == entries.end() || it->name != name) {
+        return false;
+    }
+
+    return getStat(romPath + "/" + name, &entry.size, &entry.mtime)
+           && entry.size == it->size && entry.mtime == it->mtime;
+}
+
+std::vector<std::string> Snapshot::getNames(const std::string &dir) const {
+    std::vector<std::string> names;
+    Entry entry;
+    entry.name = dir + "/";
+
+    // entries are sorted, the directory files are contiguous
+    for (auto it = std::lower_bound(entries.begin(), entries.end(), entry, sortByName);
+         it != entries.end() && it->name.compare(0, entry.name.size(), entry.name) == 0; ++it) {
+        names.push_back(it->name);
+    }
+
+    return names;
+}
+
+std::string Snapshot::getName(const std::string &romPath, const Io::File &file) {
+    // recursive lists are relative to the roms folder
+    return file.path.compare(0, romPath.size() + 1, romPath + "/") == 0
+           ? file.path.substr(romPath.size() + 1) : file.name;
+}
+
+std::vector<Io::File> Snapshot::getFiles(const std::string &romPath) const {
+    std::vector<Io::File> files;
+    files.reserve(entries.size());
+
+    for (const auto &entry: entries) {
+        Io::File file;
+        size_t sep = entry.name.rfind('/');
+        file.name = sep != std::string::npos ? entry.name.substr(sep + 1) : entry.name;
+        file.path = romPath + "/" + entry.name;
+        file.isFile = true;
+        files.push_back(std::move(file));
+    }
+
+    return files;
+}
@@ -3,16 +3,28 @@
 //
 
 #include <algorithm>
+#include <chrono>
+#include <ctime>
 #include "ss_api.h"
 #include "ss_systemlist.h"
 
 using namespace ss_api;
 
-SystemList::SystemList(const std::string &ssid, const std::string &sspassword, int retryDelay) {
+#define SS_SYSTEMLIST_MAGIC "sscrap-systems"
+#define SS_SYSTEMLIST_VERSION 2
+
+static std::string clean(const std::string &str) {
+    std::string cleaned = str;
+    std::replace(cleaned.begin(), cleaned.end(), '\t', ' ');
+    std::replace(cleaned.begin(), cleaned.end(), '\n', ' ');
+    return cleaned;
+}
+
+SystemList::SystemList(const std::string &ssid, const std::string &sspassword, bool retry) {
     long code = 0;
     Curl ss_curl;
     std::string soft = ss_curl.escape(Api::ss_softname);
-    std::string url = "https://www.screenscraper.fr/api2/systemesListe.php?devid="
+    std::string url = Api::ss_baseurl + "systemesListe.php?devid="
                       + Api::ss_devid + "&devpassword=" + Api::ss_devpassword
                       + "&softname=" + soft + "&output=xml";
 
@@ -21,12 +33,16 @@ SystemList::SystemList(const std::string &ssid, const std::string &sspassword, i
 
     SS_PRINT("SystemList: %s\n", url.c_str());
 
-    std::string xml = ss_curl.getString(url, SS_TIMEOUT, &code);
-    if (retryDelay > 0) {
+    // reuse this thread response buffer
+    std::string &xml = Curl::getBuffer();
+    ss_curl.getString(url, SS_TIMEOUT, &code, &xml);
+    if (retry) {
+        int retries = 0;
         while (code == 429 || code == 28) {
-            Api::printe((int) code, retryDelay);
-            Io::delay(retryDelay);
-            xml = ss_curl.getString(url, SS_TIMEOUT, &code);
+            int delay = RateLimiter::getRetryDelay((int) code, retries++, ss_curl.retryAfter);
+            Api::printe((int) code, (delay + 999) / 1000);
+            Io::delayMs(delay);
+            ss_curl.getString(url, SS_TIMEOUT, &code, &xml);
         }
     }
 
@@ -145,3 +161,91 @@ std::vector<std::string> SystemList::getNames() {
 
     return list;
 }
+
+bool SystemList::save(const std::string &path) const {
+    // written to a temporary file first, a partial list is never left at "path" (interrupted refresh,
+    // concurrent processes: the temporary name is unique)
+    std::string tmpPath = path + ".tmp" + std::to_string(
+            (long long) std::chrono::steady_clock::now().time_since_epoch().count());
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        SS_PRINT("SystemList::save: could not create %s\n", tmpPath.c_str());
+        return false;
+    }
+
+    fprintf(file, "%s %i %lld %zu\n", SS_SYSTEMLIST_MAGIC, SS_SYSTEMLIST_VERSION,
+            (long long) time(nullptr), systems.size());
+    for (const auto &system: systems) {
+        fprintf(file, "%i\t%i\t%s\n", system.id, system.parentId, clean(system.name).c_str());
+    }
+
+    if (fclose(file) != 0) {
+        ::remove(tmpPath.c_str());
+        return false;
+    }
+#ifdef __WINDOWS__
+    ::remove(path.c_str());
+#endif
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool SystemList::load(const std::string &path, long ttl, bool *expired) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::string data;
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, read);
+    }
+    fclose(file);
+
+    char magic[32] = {};
+    int version = 0;
+    long long date = 0;
+    size_t count = 0;
+    size_t pos = data.find('\n');
+    if (pos == std::string::npos
+        || sscanf(data.substr(0, pos).c_str(), "%31s %i %lld %zu", magic, &version, &date, &count) != 4
+        || std::string(magic) != SS_SYSTEMLIST_MAGIC || version != SS_SYSTEMLIST_VERSION) {
+        SS_PRINT("SystemList::load: invalid file: %s\n", path.c_str());
+        return false;
+    }
+
+    std::vector<System> list;
+    while (++pos < data.size()) {
+        size_t end = data.find('\n', pos);
+        if (end == std::string::npos) end = data.size();
+        size_t tab1 = data.find('\t', pos);
+        size_t tab2 = tab1 != std::string::npos ? data.find('\t', tab1 + 1) : std::string::npos;
+        if (tab2 == std::string::npos || tab2 > end) {
+            SS_PRINT("SystemList::load: invalid file: %s\n", path.c_str());
+            return false;
+        }
+        list.emplace_back(Api::parseInt(data.substr(pos, tab1 - pos)),
+                          Api::parseInt(data.substr(tab1 + 1, tab2 - tab1 - 1)),
+                          data.substr(tab2 + 1, end - tab2 - 1));
+        pos = end;
+    }
+
+    // truncated file (missing entries, or a partial last one)
+    if (list.size() != count || data.back() != '\n') {
+        SS_PRINT("SystemList::load: invalid file: %s\n", path.c_str());
+        return false;
+    }
+
+    systems = list;
+    if (expired != nullptr) {
+        *expired = ttl > 0 && (long long) time(nullptr) - date > ttl;
+    }
+
+    return true;
+}
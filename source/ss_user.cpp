@@ -6,12 +6,12 @@
 
 using namespace ss_api;
 
-User::User(const std::string &ssid, const std::string &sspassword, int retryDelay) {
+User::User(const std::string &ssid, const std::string &sspassword, bool retry) {
 
     long code = 0;
     Curl ss_curl;
     std::string soft = ss_curl.escape(Api::ss_softname);
-    std::string url = "https://www.screenscraper.fr/api2/ssuserInfos.php?devid="
+    std::string url = Api::ss_baseurl + "ssuserInfos.php?devid="
                       + Api::ss_devid + "&devpassword=" + Api::ss_devpassword
                       + "&softname=" + soft + "&output=xml";
 
@@ -20,12 +20,16 @@ User::User(const std::string &ssid, const std::string &sspassword, int retryDela
 
     SS_PRINT("User: %s\n", url.c_str());
 
-    std::string xml = ss_curl.getString(url, SS_TIMEOUT, &code);
-    if (retryDelay > 0) {
+    // reuse this thread response buffer
+    std::string &xml = Curl::getBuffer();
+    ss_curl.getString(url, SS_TIMEOUT, &code, &xml);
+    if (retry) {
+        int retries = 0;
         while (code == 429 || code == 28) {
-            Api::printe((int) code, retryDelay);
-            Io::delay(retryDelay);
-            xml = ss_curl.getString(url, SS_TIMEOUT, &code);
+            int delay = RateLimiter::getRetryDelay((int) code, retries++, ss_curl.retryAfter);
+            Api::printe((int) code, (delay + 999) / 1000);
+            Io::delayMs(delay);
+            ss_curl.getString(url, SS_TIMEOUT, &code, &xml);
         }
     }
 
@@ -77,6 +81,7 @@ bool User::parseUser(User *user, tinyxml2::XMLNode *userNode) {
     user->maxdownloadspeed = Api::getXmlTextStr(userNode->FirstChildElement("maxdownloadspeed"));
     user->requeststoday = Api::getXmlTextStr(userNode->FirstChildElement("requeststoday"));
     user->maxrequestsperday = Api::getXmlTextStr(userNode->FirstChildElement("maxrequestsperday"));
+    user->maxrequestspermin = Api::getXmlTextStr(userNode->FirstChildElement("maxrequestspermin"));
     user->visites = Api::getXmlTextStr(userNode->FirstChildElement("visites"));
     user->datedernierevisite = Api::getXmlTextStr(userNode->FirstChildElement("datedernierevisite"));
     user->favregion = Api::getXmlTextStr(userNode->FirstChildElement("favregion"));
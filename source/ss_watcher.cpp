@@ -0,0 +1,254 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <algorithm>
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "ss_api.h"
+#include "ss_watcher.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#define SS_WATCH_EVENTS (IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE)
+#endif
+
+using namespace ss_api;
+
+Watcher::Watcher(const std::string &path, bool recursive, const std::vector<std::string> &filters, int debounceMs)
+        : path(path), recursive(recursive), filters(filters), debounceMs(debounceMs) {}
+
+bool Watcher::accept(const std::string &name) const {
+    // skip "hidden" files, like Io::getDirList
+    if (name.empty() || name[0] == '.') {
+        return false;
+    }
+    if (filters.empty()) {
+        return true;
+    }
+    for (const auto &filter: filters) {
+        if (name.find(filter) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef __linux__
+
+Watcher::~Watcher() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void Watcher::addWatch(const std::string &dir, bool notify) {
+    int wd = inotify_add_watch(fd, dir.c_str(), SS_WATCH_EVENTS | IN_ONLYDIR);
+    if (wd < 0) {
+        SS_PRINT("Watcher::addWatch: could not watch %s\n", dir.c_str());
+        return;
+    }
+    watches[wd] = dir;
+
+    // a directory created while watching may already contain files (copied or moved in)
+    DIR *d = (recursive || notify) ? opendir(dir.c_str()) : nullptr;
+    if (d == nullptr) {
+        return;
+    }
+    struct dirent *ent;
+    while ((ent = readdir(d)) != nullptr) {
+        if (ent->d_name[0] == '.') {
+            continue;
+        }
+        std::string entPath = dir + "/" + ent->d_name;
+        struct stat st{};
+        bool isDir = ent->d_type == DT_DIR
+                     || (ent->d_type == DT_UNKNOWN && stat(entPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode));
+        if (isDir) {
+            if (recursive) {
+                addWatch(entPath, notify);
+            }
+        } else if (notify && accept(ent->d_name)) {
+            pending[entPath] = Clock::now();
+        }
+    }
+    closedir(d);
+}
+
+void Watcher::removeWatch(const std::string &dir) {
+    // a moved out directory is still watched, under its old path
+    std::string prefix = dir + "/";
+    for (auto it = watches.begin(); it != watches.end();) {
+        if (it->second == dir || it->second.compare(0, prefix.size(), prefix) == 0) {
+            inotify_rm_watch(fd, it->first);
+            it = watches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = pending.lower_bound(prefix); it != pending.end()
+                                                && it->first.compare(0, prefix.size(), prefix) == 0;) {
+        it = pending.erase(it);
+    }
+}
+
+bool Watcher::start() {
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        SS_PRINT("Watcher::start: inotify_init1 failed\n");
+        return false;
+    }
+
+    addWatch(path, false);
+
+    return !watches.empty();
+}
+
+bool Watcher::wait(Changes *changes) {
+    changes->changed.clear();
+    changes->removed.clear();
+    changes->rescan = false;
+
+    // events are aligned on struct inotify_event
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    while (true) {
+        // report the files left untouched for "debounceMs"
+        Clock::time_point now = Clock::now();
+        int timeout = -1;
+        for (auto it = pending.begin(); it != pending.end();) {
+            int left = debounceMs - (int) std::chrono::duration_cast<std::chrono::milliseconds>(
+                    now - it->second).count();
+            if (left <= 0) {
+                changes->changed.push_back(it->first);
+                it = pending.erase(it);
+            } else {
+                timeout = timeout < 0 ? left : std::min(timeout, left);
+                ++it;
+            }
+        }
+        if (!changes->changed.empty() || !removed.empty() || overflow) {
+            changes->removed.swap(removed);
+            changes->rescan = overflow;
+            overflow = false;
+            return true;
+        }
+
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int res = poll(&pfd, 1, timeout);
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (res == 0) {
+            continue;
+        }
+
+        ssize_t len;
+        while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+            now = Clock::now();
+            for (char *ptr = buffer; ptr < buffer + len;) {
+                auto *event = (struct inotify_event *) ptr;
+                ptr += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    overflow = true;
+                    continue;
+                }
+                if (event->mask & IN_IGNORED) {
+                    watches.erase(event->wd);
+                    continue;
+                }
+                auto watch = watches.find(event->wd);
+                if (watch == watches.end() || event->len == 0) {
+                    continue;
+                }
+
+                std::string name = event->name;
+                std::string file = watch->second + "/" + name;
+                if (event->mask & IN_ISDIR) {
+                    if (!recursive || name[0] == '.') {
+                        continue;
+                    }
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        addWatch(file, true);
+                    } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                        removeWatch(file);
+                        removed.push_back(file);
+                    }
+                    continue;
+                }
+                if (!accept(name)) {
+                    continue;
+                }
+
+                if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    pending.erase(file);
+                    removed.push_back(file);
+                } else {
+                    pending[file] = now;
+                }
+            }
+        }
+    }
+}
+
+#else
+
+Watcher::~Watcher() = default;
+
+bool Watcher::start() {
+    return snapshot.scan(path, recursive, filters);
+}
+
+bool Watcher::wait(Changes *changes) {
+    changes->changed.clear();
+    changes->removed.clear();
+    changes->rescan = false;
+
+    while (true) {
+        Io::delayMs(SS_WATCH_POLL_MS);
+        Snapshot current;
+        if (!current.scan(path, recursive, filters)) {
+            return false;
+        }
+        Snapshot::Diff diff = snapshot.diff(current);
+        if (diff.empty()) {
+            continue;
+        }
+
+        // wait for the files to be left untouched
+        while (true) {
+            Io::delayMs(debounceMs);
+            Snapshot next;
+            if (!next.scan(path, recursive, filters)) {
+                return false;
+            }
+            if (current.diff(next).empty()) {
+                break;
+            }
+            current = next;
+        }
+
+        diff = snapshot.diff(current);
+        snapshot = current;
+        for (const auto &name: diff.added) {
+            changes->changed.push_back(path + "/" + name);
+        }
+        for (const auto &name: diff.modified) {
+            changes->changed.push_back(path + "/" + name);
+        }
+        for (const auto &name: diff.removed) {
+            changes->removed.push_back(path + "/" + name);
+        }
+        return true;
+    }
+}
+
+#endif
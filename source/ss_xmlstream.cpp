@@ -0,0 +1,316 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+#include <cstring>
+#include "ss_api.h"
+#include "ss_xmlstream.h"
+
+using namespace ss_api;
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static const char *find(const char *data, size_t size, const char *needle) {
+    size_t len = strlen(needle);
+    if (size < len) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i <= size - len; i++) {
+        if (data[i] == needle[0] && memcmp(data + i, needle, len) == 0) {
+            return data + i;
+        }
+    }
+
+    return nullptr;
+}
+
+static void appendUtf8(std::string *str, unsigned long cp) {
+    if (cp < 0x80) {
+        str->push_back((char) cp);
+    } else if (cp < 0x800) {
+        str->push_back((char) (0xC0 | (cp >> 6)));
+        str->push_back((char) (0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        str->push_back((char) (0xE0 | (cp >> 12)));
+        str->push_back((char) (0x80 | ((cp >> 6) & 0x3F)));
+        str->push_back((char) (0x80 | (cp & 0x3F)));
+    } else if (cp < 0x110000) {
+        str->push_back((char) (0xF0 | (cp >> 18)));
+        str->push_back((char) (0x80 | ((cp >> 12) & 0x3F)));
+        str->push_back((char) (0x80 | ((cp >> 6) & 0x3F)));
+        str->push_back((char) (0x80 | (cp & 0x3F)));
+    }
+}
+
+// decode entities and normalize new lines (like tinyxml2)
+static void decode(std::string *dst, const char *data, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        char c = data[i];
+        if (c == '&') {
+            const char *end = (const char *) memchr(data + i, ';', size - i);
+            if (end != nullptr) {
+                std::string entity(data + i + 1, end - (data + i + 1));
+                bool known = true;
+                if (entity == "amp") {
+                    dst->push_back('&');
+                } else if (entity == "lt") {
+                    dst->push_back('<');
+                } else if (entity == "gt") {
+                    dst->push_back('>');
+                } else if (entity == "quot") {
+                    dst->push_back('"');
+                } else if (entity == "apos") {
+                    dst->push_back('\'');
+                } else if (entity.size() > 1 && entity[0] == '#') {
+                    bool hex = entity[1] == 'x' || entity[1] == 'X';
+                    unsigned long cp = strtoul(entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10);
+                    appendUtf8(dst, cp);
+                } else {
+                    known = false;
+                }
+                if (known) {
+                    i = (end - data) + 1;
+                    continue;
+                }
+            }
+        } else if (c == '\r') {
+            dst->push_back('\n');
+            i += (i + 1 < size && data[i + 1] == '\n') ? 2 : 1;
+            continue;
+        }
+        dst->push_back(c);
+        i++;
+    }
+}
+
+bool XmlStream::feed(const char *data, size_t size) {
+    if (error || data == nullptr || size == 0) {
+        return !error;
+    }
+
+    empty = false;
+
+    // parse directly from curl buffer, only keep incomplete tokens
+    if (buffer.empty()) {
+        size_t consumed = parse(data, size);
+        if (!error && consumed < size) {
+            buffer.assign(data + consumed, size - consumed);
+        }
+    } else {
+        buffer.append(data, size);
+        size_t consumed = parse(buffer.data(), buffer.size());
+        buffer.erase(0, consumed);
+    }
+
+    if (error) {
+        buffer.clear();
+    }
+
+    return !error;
+}
+
+size_t XmlStream::parse(const char *data, size_t size) {
+    size_t pos = 0;
+
+    while (pos < size && !error) {
+        const char *p = data + pos;
+        size_t left = size - pos;
+
+        if (*p != '<') {
+            const char *lt = (const char *) memchr(p, '<', left);
+            if (lt == nullptr) {
+                // keep a possibly truncated entity for the next chunk
+                size_t len = left;
+                for (size_t i = left; i > 0; i--) {
+                    if (p[i - 1] == ';') break;
+                    if (p[i - 1] == '&') {
+                        len = i - 1;
+                        break;
+                    }
+                }
+                appendText(p, len);
+                return pos + len;
+            }
+            appendText(p, lt - p);
+            pos += lt - p;
+            continue;
+        }
+
+        // comment, cdata, declaration/doctype or tag
+        const char *end;
+        if (left < 9) {
+            // not enough data to identify the token type
+            if (memchr(p, '>', left) == nullptr) {
+                return pos;
+            }
+        }
+        if (left >= 4 && memcmp(p, "<!--", 4) == 0) {
+            end = find(p + 4, left - 4, "-->");
+            if (end == nullptr) return pos;
+            pos = (end - data) + 3;
+        } else if (left >= 9 && memcmp(p, "<![CDATA[", 9) == 0) {
+            end = find(p + 9, left - 9, "]]>");
+            if (end == nullptr) return pos;
+            if (!texts.empty()) texts.back().append(p + 9, end - (p + 9));
+            pos = (end - data) + 3;
+        } else if (left >= 2 && p[1] == '?') {
+            end = find(p + 2, left - 2, "?>");
+            if (end == nullptr) return pos;
+            pos = (end - data) + 2;
+        } else if (left >= 2 && p[1] == '!') {
+            end = (const char *) memchr(p, '>', left);
+            if (end == nullptr) return pos;
+            pos = (end - data) + 1;
+        } else {
+            // find tag end, skipping quoted attributes values
+            char quote = 0;
+            end = nullptr;
+            for (size_t i = 1; i < left; i++) {
+                if (quote) {
+                    if (p[i] == quote) quote = 0;
+                } else if (p[i] == '"' || p[i] == '\'') {
+                    quote = p[i];
+                } else if (p[i] == '>') {
+                    end = p + i;
+                    break;
+                }
+            }
+            if (end == nullptr) return pos;
+            if (!parseTag(p + 1, end - (p + 1))) {
+                error = true;
+                SS_PRINT("XmlStream: syntax error\n");
+            }
+            pos = (end - data) + 1;
+        }
+    }
+
+    return pos;
+}
+
+bool XmlStream::parseTag(const char *data, size_t size) {
+    if (size == 0) {
+        return false;
+    }
+
+    // end tag
+    if (data[0] == '/') {
+        size_t len = size - 1;
+        while (len > 0 && isSpace(data[len])) len--;
+        std::string name(data + 1, len);
+        if (elements.empty() || elements.back() != name) {
+            return false;
+        }
+        std::string text = std::move(texts.back());
+        size_t depth = elements.size();
+        onEndElement(name, text, depth);
+        elements.pop_back();
+        texts.pop_back();
+        if (elements.empty()) {
+            complete = true;
+        }
+        return true;
+    }
+
+    bool closed = data[size - 1] == '/';
+    if (closed) {
+        size--;
+    }
+
+    // start tag
+    size_t i = 0;
+    while (i < size && !isSpace(data[i])) i++;
+    std::string name(data, i);
+    if (name.empty() || (complete && elements.empty())) {
+        return false;
+    }
+
+    Attributes attributes;
+    while (i < size) {
+        while (i < size && isSpace(data[i])) i++;
+        if (i >= size) break;
+        size_t start = i;
+        while (i < size && data[i] != '=' && !isSpace(data[i])) i++;
+        std::string attrName(data + start, i - start);
+        while (i < size && isSpace(data[i])) i++;
+        if (i >= size || data[i] != '=') return false;
+        i++;
+        while (i < size && isSpace(data[i])) i++;
+        if (i >= size || (data[i] != '"' && data[i] != '\'')) return false;
+        char quote = data[i++];
+        start = i;
+        while (i < size && data[i] != quote) i++;
+        if (i >= size) return false;
+        std::string value;
+        decode(&value, data + start, i - start);
+        attributes.emplace_back(attrName, value);
+        i++;
+    }
+
+    elements.emplace_back(name);
+    texts.emplace_back();
+    onStartElement(name, attributes, elements.size());
+
+    if (closed) {
+        onEndElement(name, "", elements.size());
+        elements.pop_back();
+        texts.pop_back();
+        if (elements.empty()) {
+            complete = true;
+        }
+    }
+
+    return true;
+}
+
+void XmlStream::appendText(const char *data, size_t size) {
+    if (size == 0 || texts.empty()) {
+        return;
+    }
+
+    decode(&texts.back(), data, size);
+}
+
+void XmlStream::reset() {
+    buffer.clear();
+    elements.clear();
+    texts.clear();
+    empty = true;
+    complete = false;
+    error = false;
+}
+
+bool XmlStream::isEmpty() const {
+    return empty;
+}
+
+bool XmlStream::isComplete() const {
+    return complete && !error;
+}
+
+bool XmlStream::hasError() const {
+    return error;
+}
+
+const std::string &XmlStream::getElement(size_t depth) const {
+    static const std::string none;
+    if (depth == 0 || depth > elements.size()) {
+        return none;
+    }
+
+    return elements.at(depth - 1);
+}
+
+std::string XmlStream::getAttribute(const Attributes &attributes,
+                                    const std::string &name, const std::string &defaultValue) {
+    for (const auto &attribute: attributes) {
+        if (attribute.first == name) {
+            return attribute.second;
+        }
+    }
+
+    return defaultValue;
+}
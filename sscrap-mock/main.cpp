@@ -0,0 +1,400 @@
+//
+// Created by cpasjuste on 16/10/2026.
+//
+
+// sscrap-mock: minimal local screenscraper api server, for offline load testing of sscrap-utility
+// usage: sscrap-mock [-port 8080] [-latency ms] [-jitter ms] [-429 percent] [-404 percent]
+//                    [-quota requests] [-threads n] [-rpm requests] [-media bytes] [-d]
+// then: sscrap-utility -url http://127.0.0.1:8080/api2/ ...
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <csignal>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+struct Options {
+    int port = 8080;
+    int latency = 0;
+    int jitter = 0;
+    int rate429 = 0;
+    int rate404 = 0;
+    long quota = 0;
+    int threads = 4;
+    int perMin = 600;
+    size_t mediaSize = 64 * 1024;
+    bool debug = false;
+};
+
+static Options options;
+static std::atomic<long> apiRequests(0);
+static std::atomic<long> mediaRequests(0);
+static std::atomic<long> errors429(0);
+static std::atomic<long> errors430(0);
+static std::string media;
+
+static const char *mediaTypes[] = {"ss", "sstitle", "box-2D", "box-3D", "mixrbv1", "mixrbv2", "wheel", "fanart"};
+
+static int getArg(int argc, char *argv[], const char *name, int defaultValue) {
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return (int) strtol(argv[i + 1], nullptr, 10);
+        }
+    }
+    return defaultValue;
+}
+
+static bool hasArg(int argc, char *argv[], const char *name) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int getRandom(int max) {
+    static thread_local std::mt19937 rng(std::random_device{}());
+    return std::uniform_int_distribution<int>(0, max - 1)(rng);
+}
+
+static std::string urlDecode(const std::string &str) {
+    std::string decoded;
+    for (size_t i = 0; i < str.size(); i++) {
+        if (str[i] == '%' && i + 2 < str.size()) {
+            decoded += (char) strtol(str.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else if (str[i] == '+') {
+            decoded += ' ';
+        } else {
+            decoded += str[i];
+        }
+    }
+    return decoded;
+}
+
+static std::string xmlEscape(const std::string &str) {
+    std::string escaped;
+    for (char c: str) {
+        if (c == '&') escaped += "&amp;";
+        else if (c == '<') escaped += "&lt;";
+        else if (c == '>') escaped += "&gt;";
+        else if (c == '"') escaped += "&quot;";
+        else escaped += c;
+    }
+    return escaped;
+}
+
+static std::string getParam(const std::string &query, const std::string &name) {
+    size_t pos = 0;
+    while (pos < query.size()) {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos) end = query.size();
+        size_t eq = query.find('=', pos);
+        if (eq != std::string::npos && eq < end && query.compare(pos, eq - pos, name) == 0) {
+            return urlDecode(query.substr(eq + 1, end - eq - 1));
+        }
+        pos = end + 1;
+    }
+    return "";
+}
+
+static std::string getUser() {
+    return "<ssuser><id>mock</id><niveau>1</niveau><contribution>0</contribution>"
+           "<maxthreads>" + std::to_string(options.threads) + "</maxthreads>"
+           "<maxdownloadspeed>10000</maxdownloadspeed>"
+           "<requeststoday>" + std::to_string(apiRequests.load()) + "</requeststoday>"
+           "<maxrequestsperday>" + std::to_string(options.quota > 0 ? options.quota : 100000) + "</maxrequestsperday>"
+           "<maxrequestspermin>" + std::to_string(options.perMin) + "</maxrequestspermin>"
+           "<favregion>wor</favregion></ssuser>";
+}
+
+static std::string getGame(const std::string &host, unsigned long id, const std::string &name,
+                           const std::string &romName, const std::string &systemId) {
+    std::string xml = "<jeu id=\"" + std::to_string(id) + "\" romid=\"" + std::to_string(id) + "\">";
+    xml += "<noms><nom region=\"us\">" + xmlEscape(name) + " (us)</nom>"
+           "<nom region=\"wor\">" + xmlEscape(name) + "</nom></noms>";
+    xml += "<cloneof>0</cloneof>";
+    xml += "<systeme id=\"" + systemId + "\" parentid=\"0\">Mock System</systeme>";
+    xml += "<editeur id=\"1\">Mock Editor</editeur><developpeur id=\"2\">Mock Developer</developpeur>";
+    xml += "<joueurs>1-2</joueurs><note>15</note><rotation>0</rotation><resolution>320x224</resolution>";
+    xml += "<synopsis><synopsis langue=\"fr\">Jeu de test.</synopsis>"
+           "<synopsis langue=\"en\">A mock game, served by sscrap-mock for load testing.</synopsis></synopsis>";
+    xml += "<dates><date region=\"jp\">1991-01-01</date><date region=\"wor\">1992-01-01</date></dates>";
+    xml += "<genres><genre id=\"10\" principale=\"1\" langue=\"fr\">Action</genre>"
+           "<genre id=\"10\" principale=\"1\" langue=\"en\">Action</genre></genres>";
+    xml += "<rom><romfilename>" + xmlEscape(romName) + "</romfilename></rom>";
+    xml += "<medias>";
+    std::string url = "http://" + host + "/medias/" + std::to_string(id) + "/";
+    for (const char *type: mediaTypes) {
+        for (const char *region: {"eu", "us", "wor"}) {
+            xml += "<media type=\"" + std::string(type) + "\" parent=\"jeu\" region=\"" + region
+                   + "\" format=\"png\">" + xmlEscape(url + type + "-" + region + ".png?crc=0") + "</media>";
+        }
+    }
+    xml += "<media type=\"video\" parent=\"jeu\" format=\"mp4\">" + xmlEscape(url + "video.mp4") + "</media>";
+    xml += "</medias></jeu>";
+
+    return xml;
+}
+
+static unsigned long hash(const std::string &str) {
+    unsigned long h = 5381;
+    for (char c: str) {
+        h = ((h << 5) + h) + (unsigned char) c;
+    }
+    return h % 1000000;
+}
+
+// returns http status code and fills body
+static int handle(const std::string &path, const std::string &query, const std::string &host, std::string *body) {
+    std::string page = path.substr(path.rfind('/') + 1);
+
+    if (path.compare(0, 8, "/medias/") == 0) {
+        mediaRequests++;
+        *body = media;
+        return 200;
+    }
+
+    long count = ++apiRequests;
+    if (options.quota > 0 && count > options.quota) {
+        errors430++;
+        *body = "Votre quota de scrape est dépassé pour aujourd'hui !";
+        return 430;
+    }
+
+    if (options.rate429 > 0 && getRandom(100) < options.rate429) {
+        errors429++;
+        *body = "Le nombre de requêtes par minutes est dépassé";
+        return 429;
+    }
+
+    std::string header = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Data>";
+
+    if (page == "ssuserInfos.php") {
+        *body = header + getUser() + "</Data>";
+    } else if (page == "systemesListe.php") {
+        // same layout as expected by SystemList
+        *body = header;
+        for (int id = 1; id < 300; id++) {
+            *body += "<systeme><id>" + std::to_string(id) + "</id><parentid>0</parentid>"
+                     "<noms><nom_eu>Mock System " + std::to_string(id) + "</nom_eu></noms></systeme>";
+        }
+        *body += "</Data>";
+    } else if (page == "mediasJeuListe.php") {
+        *body = header + "<medias>";
+        int id = 1;
+        for (const char *type: mediaTypes) {
+            *body += "<media><id>" + std::to_string(id++) + "</id><nomcourt>" + type + "</nomcourt>"
+                     "<nom>" + type + "</nom><categorie>Images</categorie><type>Image</type>"
+                     "<fileformat>png</fileformat></media>";
+        }
+        *body += "<media><id>" + std::to_string(id) + "</id><nomcourt>video</nomcourt><nom>video</nom>"
+                 "<categorie>Videos</categorie><type>Video</type><fileformat>mp4</fileformat></media>";
+        *body += "</medias></Data>";
+    } else if (page == "jeuInfos.php") {
+        std::string romName = getParam(query, "romnom");
+        std::string key = getParam(query, "crc") + getParam(query, "md5") + getParam(query, "sha1") + romName;
+        if (options.rate404 > 0 && getRandom(100) < options.rate404) {
+            *body = "Erreur : Rom/Iso/Dossier non trouvée !";
+            return 404;
+        }
+        std::string name = romName.substr(0, romName.find_last_of('.'));
+        *body = header + getUser() + getGame(host, hash(key), name, romName, getParam(query, "systemeid")) + "</Data>";
+    } else if (page == "jeuRecherche.php") {
+        std::string name = getParam(query, "recherche");
+        *body = header + getUser() + "<jeux>";
+        for (int i = 0; i < 5; i++) {
+            std::string n = i == 0 ? name : name + " " + std::to_string(i + 1);
+            *body += getGame(host, hash(n), n, "", getParam(query, "systemeid"));
+        }
+        *body += "</jeux></Data>";
+    } else {
+        *body = "Erreur : API inconnue";
+        return 404;
+    }
+
+    return 200;
+}
+
+static bool sendAll(int fd, const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += (size_t) n;
+    }
+    return true;
+}
+
+static void client_thread(int fd) {
+    std::string buffer;
+    char chunk[8192];
+
+    while (true) {
+        // read request headers (body ignored, GET only)
+        size_t end;
+        while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                close(fd);
+                return;
+            }
+            buffer.append(chunk, (size_t) n);
+        }
+
+        std::string request = buffer.substr(0, end);
+        buffer.erase(0, end + 4);
+
+        size_t sp1 = request.find(' ');
+        size_t sp2 = request.find(' ', sp1 + 1);
+        if (sp1 == std::string::npos || sp2 == std::string::npos) {
+            close(fd);
+            return;
+        }
+        std::string target = request.substr(sp1 + 1, sp2 - sp1 - 1);
+        std::string path = target.substr(0, target.find('?'));
+        std::string query = target.find('?') != std::string::npos ? target.substr(target.find('?') + 1) : "";
+
+        std::string host = "127.0.0.1:" + std::to_string(options.port);
+        bool keepAlive = true;
+        size_t pos = request.find("\r\n");
+        while (pos != std::string::npos && pos < request.size()) {
+            size_t next = request.find("\r\n", pos + 2);
+            std::string line = request.substr(pos + 2, next == std::string::npos ? std::string::npos : next - pos - 2);
+            std::string lower = line;
+            for (auto &c: lower) c = (char) tolower(c);
+            if (lower.compare(0, 5, "host:") == 0) {
+                host = line.substr(5);
+                host.erase(0, host.find_first_not_of(' '));
+            } else if (lower.compare(0, 11, "connection:") == 0 && lower.find("close") != std::string::npos) {
+                keepAlive = false;
+            }
+            pos = next;
+        }
+
+        if (options.latency > 0 || options.jitter > 0) {
+            int ms = options.latency + (options.jitter > 0 ? getRandom(options.jitter) : 0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        }
+
+        std::string body;
+        int code = handle(path, query, host, &body);
+        if (options.debug) {
+            printf("%i %s\n", code, target.c_str());
+        }
+
+        const char *status = code == 200 ? "OK" : code == 404 ? "Not Found"
+                                                 : code == 429 ? "Too Many Requests" : "Quota Exceeded";
+        std::string response = "HTTP/1.1 " + std::to_string(code) + " " + status + "\r\n";
+        response += path.compare(0, 8, "/medias/") == 0 ? "Content-Type: image/png\r\n"
+                                                       : "Content-Type: text/xml; charset=utf-8\r\n";
+        if (code == 429) {
+            response += "Retry-After: 1\r\n";
+        }
+        response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        response += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        response += body;
+
+        if (!sendAll(fd, response) || !keepAlive) {
+            close(fd);
+            return;
+        }
+    }
+}
+
+// set by SIGINT/SIGTERM, stats are printed from the main loop (printf is not async-signal-safe)
+static volatile sig_atomic_t stopRequested = 0;
+
+static void stop_handler(int) {
+    stopRequested = 1;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (hasArg(argc, argv, "-h")) {
+        printf("usage: sscrap-mock [options]\n");
+        printf("\t-port <port>          listening port (default: 8080)\n");
+        printf("\t-latency <ms>         add latency to all requests\n");
+        printf("\t-jitter <ms>          add random (0 to ms) latency to all requests\n");
+        printf("\t-429 <percent>        api requests answered with 429 (too many requests)\n");
+        printf("\t-404 <percent>        jeuInfos requests answered with 404 (game not found)\n");
+        printf("\t-quota <requests>     api requests answered with 430 (quota exceeded) after this number\n");
+        printf("\t-threads <n>          user \"maxthreads\" (default: 4)\n");
+        printf("\t-rpm <requests>       user \"maxrequestspermin\" (default: 600)\n");
+        printf("\t-media <bytes>        medias size (default: 65536)\n");
+        printf("\t-d                    print requests\n");
+        return 0;
+    }
+
+    options.port = getArg(argc, argv, "-port", options.port);
+    options.latency = getArg(argc, argv, "-latency", options.latency);
+    options.jitter = getArg(argc, argv, "-jitter", options.jitter);
+    options.rate429 = getArg(argc, argv, "-429", options.rate429);
+    options.rate404 = getArg(argc, argv, "-404", options.rate404);
+    options.quota = getArg(argc, argv, "-quota", (int) options.quota);
+    options.threads = getArg(argc, argv, "-threads", options.threads);
+    options.perMin = getArg(argc, argv, "-rpm", options.perMin);
+    options.mediaSize = (size_t) getArg(argc, argv, "-media", (int) options.mediaSize);
+    options.debug = hasArg(argc, argv, "-d");
+
+    // pseudo png
+    media.assign("\x89PNG\r\n\x1a\n", 8);
+    media.resize(options.mediaSize > 8 ? options.mediaSize : 8, 'x');
+
+    int server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server < 0) {
+        perror("sscrap-mock: socket");
+        return 1;
+    }
+
+    int yes = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t) options.port);
+    if (bind(server, (struct sockaddr *) &addr, sizeof(addr)) != 0 || listen(server, 128) != 0) {
+        perror("sscrap-mock: bind");
+        close(server);
+        return 1;
+    }
+
+    // no SA_RESTART: accept is interrupted to check the stop flag
+    struct sigaction action = {};
+    action.sa_handler = stop_handler;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    printf("sscrap-mock: listening on http://127.0.0.1:%i/api2/\n", options.port);
+    fflush(stdout);
+
+    while (!stopRequested) {
+        int fd = accept(server, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        std::thread(client_thread, fd).detach();
+    }
+
+    printf("\nsscrap-mock: api requests: %li, media requests: %li, 429: %li, 430: %li\n",
+           apiRequests.load(), mediaRequests.load(), errors429.load(), errors430.load());
+    close(server);
+
+    return 0;
+}
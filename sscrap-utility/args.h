@@ -28,6 +28,18 @@ public:
         return s;
     }
 
+    // all values following "option", up to the next option
+    std::vector<std::string> getList(const std::string &option) const {
+        std::vector<std::string> values;
+        auto itr = std::find(this->tokens.begin(), this->tokens.end(), option);
+        if (itr != tokens.end()) {
+            while (++itr != tokens.end() && !itr->empty() && (*itr)[0] != '-') {
+                values.push_back(*itr);
+            }
+        }
+        return values;
+    }
+
     bool exist(const std::string &option) const {
         return std::find(this->tokens.begin(), this->tokens.end(), option) != this->tokens.end();
     }
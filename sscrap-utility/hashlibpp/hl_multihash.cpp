@@ -0,0 +1,1064 @@
+/*
+ * hashlib++ - a simple hash library for C++
+ *
+ * multi-buffer extension: md5/sha1/sha256 of several independent messages at once
+ */
+
+//----------------------------------------------------------------------
+
+/**
+ *  @file 	hl_multihash.cpp
+ *  @brief	This file contains the implementation of the multihash class
+ *  @date 	Fr 16 Oct 2026
+ */
+
+//----------------------------------------------------------------------
+//STL includes
+#include <cstring>
+#include <cstddef>
+#include <cstdio>
+
+//----------------------------------------------------------------------
+//hashlib++ includes
+#include "hl_multihash.h"
+
+//----------------------------------------------------------------------
+//platform includes
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(_MSC_VER))
+#define HL_MULTIHASH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define HL_TARGET_AVX2
+#define HL_TARGET_SHANI
+#else
+#include <cpuid.h>
+#define HL_TARGET_AVX2 __attribute__((target("avx2")))
+#define HL_TARGET_SHANI __attribute__((target("sha,sse4.1,ssse3")))
+#endif
+#endif
+
+//----------------------------------------------------------------------
+//defines
+
+//! blocks processed per lane before switching digest (keeps data in cache)
+#define HL_MULTIHASH_SLICE 256
+
+#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define MD5_F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define MD5_G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
+#define MD5_H(x, y, z) ((x) ^ (y) ^ (z))
+#define MD5_I(x, y, z) ((y) ^ ((x) | ~(z)))
+
+/*
+ * the 64 md5 steps: function, registers rotation,
+ * message word, shift and constant index
+ */
+#define MD5_ROUNDS(STEP) \
+	STEP(F, a, b, c, d,  0,  7,  0) \
+	STEP(F, d, a, b, c,  1, 12,  1) \
+	STEP(F, c, d, a, b,  2, 17,  2) \
+	STEP(F, b, c, d, a,  3, 22,  3) \
+	STEP(F, a, b, c, d,  4,  7,  4) \
+	STEP(F, d, a, b, c,  5, 12,  5) \
+	STEP(F, c, d, a, b,  6, 17,  6) \
+	STEP(F, b, c, d, a,  7, 22,  7) \
+	STEP(F, a, b, c, d,  8,  7,  8) \
+	STEP(F, d, a, b, c,  9, 12,  9) \
+	STEP(F, c, d, a, b, 10, 17, 10) \
+	STEP(F, b, c, d, a, 11, 22, 11) \
+	STEP(F, a, b, c, d, 12,  7, 12) \
+	STEP(F, d, a, b, c, 13, 12, 13) \
+	STEP(F, c, d, a, b, 14, 17, 14) \
+	STEP(F, b, c, d, a, 15, 22, 15) \
+	STEP(G, a, b, c, d,  1,  5, 16) \
+	STEP(G, d, a, b, c,  6,  9, 17) \
+	STEP(G, c, d, a, b, 11, 14, 18) \
+	STEP(G, b, c, d, a,  0, 20, 19) \
+	STEP(G, a, b, c, d,  5,  5, 20) \
+	STEP(G, d, a, b, c, 10,  9, 21) \
+	STEP(G, c, d, a, b, 15, 14, 22) \
+	STEP(G, b, c, d, a,  4, 20, 23) \
+	STEP(G, a, b, c, d,  9,  5, 24) \
+	STEP(G, d, a, b, c, 14,  9, 25) \
+	STEP(G, c, d, a, b,  3, 14, 26) \
+	STEP(G, b, c, d, a,  8, 20, 27) \
+	STEP(G, a, b, c, d, 13,  5, 28) \
+	STEP(G, d, a, b, c,  2,  9, 29) \
+	STEP(G, c, d, a, b,  7, 14, 30) \
+	STEP(G, b, c, d, a, 12, 20, 31) \
+	STEP(H, a, b, c, d,  5,  4, 32) \
+	STEP(H, d, a, b, c,  8, 11, 33) \
+	STEP(H, c, d, a, b, 11, 16, 34) \
+	STEP(H, b, c, d, a, 14, 23, 35) \
+	STEP(H, a, b, c, d,  1,  4, 36) \
+	STEP(H, d, a, b, c,  4, 11, 37) \
+	STEP(H, c, d, a, b,  7, 16, 38) \
+	STEP(H, b, c, d, a, 10, 23, 39) \
+	STEP(H, a, b, c, d, 13,  4, 40) \
+	STEP(H, d, a, b, c,  0, 11, 41) \
+	STEP(H, c, d, a, b,  3, 16, 42) \
+	STEP(H, b, c, d, a,  6, 23, 43) \
+	STEP(H, a, b, c, d,  9,  4, 44) \
+	STEP(H, d, a, b, c, 12, 11, 45) \
+	STEP(H, c, d, a, b, 15, 16, 46) \
+	STEP(H, b, c, d, a,  2, 23, 47) \
+	STEP(I, a, b, c, d,  0,  6, 48) \
+	STEP(I, d, a, b, c,  7, 10, 49) \
+	STEP(I, c, d, a, b, 14, 15, 50) \
+	STEP(I, b, c, d, a,  5, 21, 51) \
+	STEP(I, a, b, c, d, 12,  6, 52) \
+	STEP(I, d, a, b, c,  3, 10, 53) \
+	STEP(I, c, d, a, b, 10, 15, 54) \
+	STEP(I, b, c, d, a,  1, 21, 55) \
+	STEP(I, a, b, c, d,  8,  6, 56) \
+	STEP(I, d, a, b, c, 15, 10, 57) \
+	STEP(I, c, d, a, b,  6, 15, 58) \
+	STEP(I, b, c, d, a, 13, 21, 59) \
+	STEP(I, a, b, c, d,  4,  6, 60) \
+	STEP(I, d, a, b, c, 11, 10, 61) \
+	STEP(I, c, d, a, b,  2, 15, 62) \
+	STEP(I, b, c, d, a,  9, 21, 63)
+
+//----------------------------------------------------------------------
+//constants
+
+static const hl_uint32 md5K[64] =
+{
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const hl_uint32 sha1K[4] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+static const hl_uint32 sha256K[64] =
+{
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const hl_uint32 sha256Init[8] =
+{
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+//! readable data for the unused simd lanes
+static const hl_uint8 zeroBlock[64] = { 0 };
+
+//----------------------------------------------------------------------
+//helpers
+
+static inline hl_uint32 loadLE32(const hl_uint8 *p)
+{
+	return (hl_uint32) p[0] | ((hl_uint32) p[1] << 8) | ((hl_uint32) p[2] << 16) | ((hl_uint32) p[3] << 24);
+}
+
+static inline hl_uint32 loadBE32(const hl_uint8 *p)
+{
+	return ((hl_uint32) p[0] << 24) | ((hl_uint32) p[1] << 16) | ((hl_uint32) p[2] << 8) | (hl_uint32) p[3];
+}
+
+static inline void storeLE32(hl_uint8 *p, hl_uint32 v)
+{
+	p[0] = (hl_uint8) v; p[1] = (hl_uint8) (v >> 8); p[2] = (hl_uint8) (v >> 16); p[3] = (hl_uint8) (v >> 24);
+}
+
+static inline void storeBE32(hl_uint8 *p, hl_uint32 v)
+{
+	p[0] = (hl_uint8) (v >> 24); p[1] = (hl_uint8) (v >> 16); p[2] = (hl_uint8) (v >> 8); p[3] = (hl_uint8) v;
+}
+
+//----------------------------------------------------------------------
+//scalar implementations
+
+#define MD5_SCALAR_STEP(f, a, b, c, d, x, s, i) \
+	a += MD5_##f(b, c, d) + w[x] + md5K[i]; \
+	a = b + ROTL32(a, s);
+
+static void md5Blocks(hl_uint32 state[4], const hl_uint8 *data, size_t blocks)
+{
+	hl_uint32 w[16];
+
+	while (blocks--)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			w[i] = loadLE32(data + i * 4);
+		}
+
+		hl_uint32 a = state[0], b = state[1], c = state[2], d = state[3];
+		MD5_ROUNDS(MD5_SCALAR_STEP)
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+
+		data += 64;
+	}
+}
+
+static void sha1Blocks(hl_uint32 state[5], const hl_uint8 *data, size_t blocks)
+{
+	hl_uint32 w[80];
+
+	while (blocks--)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			w[i] = loadBE32(data + i * 4);
+		}
+		for (int i = 16; i < 80; i++)
+		{
+			hl_uint32 x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+			w[i] = ROTL32(x, 1);
+		}
+
+		hl_uint32 a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], t;
+		for (int i = 0; i < 20; i++)
+		{
+			t = ROTL32(a, 5) + (d ^ (b & (c ^ d))) + e + sha1K[0] + w[i];
+			e = d; d = c; c = ROTL32(b, 30); b = a; a = t;
+		}
+		for (int i = 20; i < 40; i++)
+		{
+			t = ROTL32(a, 5) + (b ^ c ^ d) + e + sha1K[1] + w[i];
+			e = d; d = c; c = ROTL32(b, 30); b = a; a = t;
+		}
+		for (int i = 40; i < 60; i++)
+		{
+			t = ROTL32(a, 5) + ((b & c) | (d & (b | c))) + e + sha1K[2] + w[i];
+			e = d; d = c; c = ROTL32(b, 30); b = a; a = t;
+		}
+		for (int i = 60; i < 80; i++)
+		{
+			t = ROTL32(a, 5) + (b ^ c ^ d) + e + sha1K[3] + w[i];
+			e = d; d = c; c = ROTL32(b, 30); b = a; a = t;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+
+		data += 64;
+	}
+}
+
+static void sha256Blocks(hl_uint32 state[8], const hl_uint8 *data, size_t blocks)
+{
+	hl_uint32 w[64];
+
+	while (blocks--)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			w[i] = loadBE32(data + i * 4);
+		}
+		for (int i = 16; i < 64; i++)
+		{
+			hl_uint32 s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			hl_uint32 s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		hl_uint32 a = state[0], b = state[1], c = state[2], d = state[3];
+		hl_uint32 e = state[4], f = state[5], g = state[6], h = state[7];
+		for (int i = 0; i < 64; i++)
+		{
+			hl_uint32 t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25))
+				+ (g ^ (e & (f ^ g))) + sha256K[i] + w[i];
+			hl_uint32 t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22))
+				+ ((a & b) | (c & (a | b)));
+			h = g; g = f; f = e; e = d + t1;
+			d = c; c = b; b = a; a = t1 + t2;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+
+		data += 64;
+	}
+}
+
+#ifdef HL_MULTIHASH_X86
+
+//----------------------------------------------------------------------
+//avx2 implementations (8 lanes of 32 bits)
+
+#define VROTL32(x, n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define VROTR32(x, n) VROTL32(x, 32 - (n))
+
+#define MD5_VF(x, y, z) _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+#define MD5_VG(x, y, z) _mm256_xor_si256(y, _mm256_and_si256(z, _mm256_xor_si256(x, y)))
+#define MD5_VH(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define MD5_VI(x, y, z) _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, ones)))
+
+#define MD5_AVX2_STEP(f, a, b, c, d, x, s, i) \
+	a = _mm256_add_epi32(a, _mm256_add_epi32(MD5_V##f(b, c, d), \
+		_mm256_add_epi32(w[x], _mm256_set1_epi32((int) md5K[i])))); \
+	a = _mm256_add_epi32(b, VROTL32(a, s));
+
+/**
+ *  @brief 	Load one block of each lane, transposed:
+ *  		w[i] holds the message word i of the 8 lanes
+ */
+HL_TARGET_AVX2
+static inline void loadWords8(__m256i w[16], const hl_uint8 *const ptr[8])
+{
+	for (int half = 0; half < 2; half++)
+	{
+		__m256i r[8], t[8], u[8];
+		for (int l = 0; l < 8; l++)
+		{
+			r[l] = _mm256_loadu_si256((const __m256i *) (ptr[l] + half * 32));
+		}
+		for (int l = 0; l < 8; l += 2)
+		{
+			t[l] = _mm256_unpacklo_epi32(r[l], r[l + 1]);
+			t[l + 1] = _mm256_unpackhi_epi32(r[l], r[l + 1]);
+		}
+		for (int l = 0; l < 8; l += 4)
+		{
+			u[l] = _mm256_unpacklo_epi64(t[l], t[l + 2]);
+			u[l + 1] = _mm256_unpackhi_epi64(t[l], t[l + 2]);
+			u[l + 2] = _mm256_unpacklo_epi64(t[l + 1], t[l + 3]);
+			u[l + 3] = _mm256_unpackhi_epi64(t[l + 1], t[l + 3]);
+		}
+		for (int i = 0; i < 4; i++)
+		{
+			w[half * 8 + i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+			w[half * 8 + i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+		}
+	}
+}
+
+HL_TARGET_AVX2
+static void md5Blocks8(hl_uint32 state[][8], const hl_uint8 *ptr[8], const size_t step[8], size_t blocks)
+{
+	const __m256i ones = _mm256_set1_epi32(-1);
+	__m256i sa = _mm256_loadu_si256((const __m256i *) state[0]);
+	__m256i sb = _mm256_loadu_si256((const __m256i *) state[1]);
+	__m256i sc = _mm256_loadu_si256((const __m256i *) state[2]);
+	__m256i sd = _mm256_loadu_si256((const __m256i *) state[3]);
+	__m256i w[16];
+
+	while (blocks--)
+	{
+		loadWords8(w, ptr);
+
+		__m256i a = sa, b = sb, c = sc, d = sd;
+		MD5_ROUNDS(MD5_AVX2_STEP)
+		sa = _mm256_add_epi32(sa, a);
+		sb = _mm256_add_epi32(sb, b);
+		sc = _mm256_add_epi32(sc, c);
+		sd = _mm256_add_epi32(sd, d);
+
+		for (int l = 0; l < 8; l++)
+		{
+			ptr[l] += step[l];
+		}
+	}
+
+	_mm256_storeu_si256((__m256i *) state[0], sa);
+	_mm256_storeu_si256((__m256i *) state[1], sb);
+	_mm256_storeu_si256((__m256i *) state[2], sc);
+	_mm256_storeu_si256((__m256i *) state[3], sd);
+}
+
+HL_TARGET_AVX2
+static void sha1Blocks8(hl_uint32 state[][8], const hl_uint8 *ptr[8], const size_t step[8], size_t blocks)
+{
+	const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+					       3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	__m256i s[5];
+	__m256i w[16];
+
+	for (int i = 0; i < 5; i++)
+	{
+		s[i] = _mm256_loadu_si256((const __m256i *) state[i]);
+	}
+
+	while (blocks--)
+	{
+		loadWords8(w, ptr);
+		for (int i = 0; i < 16; i++)
+		{
+			w[i] = _mm256_shuffle_epi8(w[i], bswap);
+		}
+
+		__m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4];
+		for (int i = 0; i < 80; i++)
+		{
+			__m256i x, f;
+			if (i < 16)
+			{
+				x = w[i];
+			}
+			else
+			{
+				x = _mm256_xor_si256(_mm256_xor_si256(w[(i - 3) & 15], w[(i - 8) & 15]),
+						     _mm256_xor_si256(w[(i - 14) & 15], w[i & 15]));
+				x = VROTL32(x, 1);
+				w[i & 15] = x;
+			}
+			if (i < 20)
+			{
+				f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+			}
+			else if (i < 40 || i >= 60)
+			{
+				f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+			}
+			else
+			{
+				f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c)));
+			}
+			__m256i t = _mm256_add_epi32(_mm256_add_epi32(VROTL32(a, 5), f),
+						     _mm256_add_epi32(_mm256_add_epi32(e, x),
+								      _mm256_set1_epi32((int) sha1K[i / 20])));
+			e = d;
+			d = c;
+			c = VROTL32(b, 30);
+			b = a;
+			a = t;
+		}
+		s[0] = _mm256_add_epi32(s[0], a);
+		s[1] = _mm256_add_epi32(s[1], b);
+		s[2] = _mm256_add_epi32(s[2], c);
+		s[3] = _mm256_add_epi32(s[3], d);
+		s[4] = _mm256_add_epi32(s[4], e);
+
+		for (int l = 0; l < 8; l++)
+		{
+			ptr[l] += step[l];
+		}
+	}
+
+	for (int i = 0; i < 5; i++)
+	{
+		_mm256_storeu_si256((__m256i *) state[i], s[i]);
+	}
+}
+
+HL_TARGET_AVX2
+static void sha256Blocks8(hl_uint32 state[][8], const hl_uint8 *ptr[8], const size_t step[8], size_t blocks)
+{
+	const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+					       3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	__m256i s[8];
+	__m256i w[16];
+
+	for (int i = 0; i < 8; i++)
+	{
+		s[i] = _mm256_loadu_si256((const __m256i *) state[i]);
+	}
+
+	while (blocks--)
+	{
+		loadWords8(w, ptr);
+		for (int i = 0; i < 16; i++)
+		{
+			w[i] = _mm256_shuffle_epi8(w[i], bswap);
+		}
+
+		__m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+		for (int i = 0; i < 64; i++)
+		{
+			__m256i x;
+			if (i < 16)
+			{
+				x = w[i];
+			}
+			else
+			{
+				__m256i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+				__m256i s0 = _mm256_xor_si256(_mm256_xor_si256(VROTR32(w15, 7), VROTR32(w15, 18)),
+							      _mm256_srli_epi32(w15, 3));
+				__m256i s1 = _mm256_xor_si256(_mm256_xor_si256(VROTR32(w2, 17), VROTR32(w2, 19)),
+							      _mm256_srli_epi32(w2, 10));
+				x = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0),
+						     _mm256_add_epi32(w[(i - 7) & 15], s1));
+				w[i & 15] = x;
+			}
+			__m256i e1 = _mm256_xor_si256(_mm256_xor_si256(VROTR32(e, 6), VROTR32(e, 11)), VROTR32(e, 25));
+			__m256i ch = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+			__m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, e1),
+						      _mm256_add_epi32(_mm256_add_epi32(ch, x),
+								       _mm256_set1_epi32((int) sha256K[i])));
+			__m256i a0 = _mm256_xor_si256(_mm256_xor_si256(VROTR32(a, 2), VROTR32(a, 13)), VROTR32(a, 22));
+			__m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+			h = g;
+			g = f;
+			f = e;
+			e = _mm256_add_epi32(d, t1);
+			d = c;
+			c = b;
+			b = a;
+			a = _mm256_add_epi32(t1, _mm256_add_epi32(a0, maj));
+		}
+		s[0] = _mm256_add_epi32(s[0], a);
+		s[1] = _mm256_add_epi32(s[1], b);
+		s[2] = _mm256_add_epi32(s[2], c);
+		s[3] = _mm256_add_epi32(s[3], d);
+		s[4] = _mm256_add_epi32(s[4], e);
+		s[5] = _mm256_add_epi32(s[5], f);
+		s[6] = _mm256_add_epi32(s[6], g);
+		s[7] = _mm256_add_epi32(s[7], h);
+
+		for (int l = 0; l < 8; l++)
+		{
+			ptr[l] += step[l];
+		}
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		_mm256_storeu_si256((__m256i *) state[i], s[i]);
+	}
+}
+
+//----------------------------------------------------------------------
+//sha extensions implementation
+
+/*
+ * four sha1 rounds: "cur" holds the message words of this group,
+ * the message schedule of the next groups is updated on the way
+ */
+#define SHA1NI_GROUP(f, cur, n1, n2, n3, ein, eout) \
+	ein = _mm_sha1nexte_epu32(ein, cur); \
+	eout = abcd; \
+	n1 = _mm_sha1msg2_epu32(n1, cur); \
+	abcd = _mm_sha1rnds4_epu32(abcd, ein, f); \
+	n3 = _mm_sha1msg1_epu32(n3, cur); \
+	n2 = _mm_xor_si128(n2, cur);
+
+HL_TARGET_SHANI
+static void sha1BlocksNi(hl_uint32 state[5], const hl_uint8 *data, size_t blocks)
+{
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+	__m128i abcd, abcdSave, e0, e0Save, e1, m0, m1, m2, m3;
+
+	abcd = _mm_loadu_si128((const __m128i *) state);
+	abcd = _mm_shuffle_epi32(abcd, 0x1b);
+	e0 = _mm_set_epi32((int) state[4], 0, 0, 0);
+
+	while (blocks--)
+	{
+		abcdSave = abcd;
+		e0Save = e0;
+
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 0)), mask);
+		e0 = _mm_add_epi32(e0, m0);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 16)), mask);
+		e1 = _mm_sha1nexte_epu32(e1, m1);
+		e0 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+		m0 = _mm_sha1msg1_epu32(m0, m1);
+
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 32)), mask);
+		e0 = _mm_sha1nexte_epu32(e0, m2);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+		m1 = _mm_sha1msg1_epu32(m1, m2);
+		m0 = _mm_xor_si128(m0, m2);
+
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 48)), mask);
+		SHA1NI_GROUP(0, m3, m0, m1, m2, e1, e0)
+		SHA1NI_GROUP(0, m0, m1, m2, m3, e0, e1)
+		SHA1NI_GROUP(1, m1, m2, m3, m0, e1, e0)
+		SHA1NI_GROUP(1, m2, m3, m0, m1, e0, e1)
+		SHA1NI_GROUP(1, m3, m0, m1, m2, e1, e0)
+		SHA1NI_GROUP(1, m0, m1, m2, m3, e0, e1)
+		SHA1NI_GROUP(1, m1, m2, m3, m0, e1, e0)
+		SHA1NI_GROUP(2, m2, m3, m0, m1, e0, e1)
+		SHA1NI_GROUP(2, m3, m0, m1, m2, e1, e0)
+		SHA1NI_GROUP(2, m0, m1, m2, m3, e0, e1)
+		SHA1NI_GROUP(2, m1, m2, m3, m0, e1, e0)
+		SHA1NI_GROUP(2, m2, m3, m0, m1, e0, e1)
+		SHA1NI_GROUP(3, m3, m0, m1, m2, e1, e0)
+		SHA1NI_GROUP(3, m0, m1, m2, m3, e0, e1)
+		SHA1NI_GROUP(3, m1, m2, m3, m0, e1, e0)
+		SHA1NI_GROUP(3, m2, m3, m0, m1, e0, e1)
+		SHA1NI_GROUP(3, m3, m0, m1, m2, e1, e0)
+
+		e0 = _mm_sha1nexte_epu32(e0, e0Save);
+		abcd = _mm_add_epi32(abcd, abcdSave);
+
+		data += 64;
+	}
+
+	abcd = _mm_shuffle_epi32(abcd, 0x1b);
+	_mm_storeu_si128((__m128i *) state, abcd);
+	state[4] = (hl_uint32) _mm_extract_epi32(e0, 3);
+}
+
+/*
+ * four sha256 rounds (two rnds2) with the message words "cur",
+ * "abef"/"cdgh" hold the state in the order the instructions expect
+ */
+#define SHA256NI_RNDS4(cur, i) \
+	m = _mm_add_epi32(cur, _mm_loadu_si128((const __m128i *) (sha256K + (i)))); \
+	cdgh = _mm_sha256rnds2_epu32(cdgh, abef, m); \
+	m = _mm_shuffle_epi32(m, 0x0e); \
+	abef = _mm_sha256rnds2_epu32(abef, cdgh, m);
+
+/*
+ * four sha256 rounds, then the message schedule: "next" gets its
+ * final words, "prev" (done) starts the words of the group after "next"
+ */
+#define SHA256NI_GROUP(cur, next, prev, i) \
+	SHA256NI_RNDS4(cur, i) \
+	next = _mm_sha256msg2_epu32(_mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4)), cur); \
+	prev = _mm_sha256msg1_epu32(prev, cur);
+
+HL_TARGET_SHANI
+static void sha256BlocksNi(hl_uint32 state[8], const hl_uint8 *data, size_t blocks)
+{
+	const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i abef, cdgh, abefSave, cdghSave, m, m0, m1, m2, m3, t;
+
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) state), 0xb1);		//cdab
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) (state + 4)), 0x1b);	//efgh
+	abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+
+	while (blocks--)
+	{
+		abefSave = abef;
+		cdghSave = cdgh;
+
+		m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 0)), mask);
+		m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 16)), mask);
+		m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 32)), mask);
+		m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 48)), mask);
+
+		SHA256NI_RNDS4(m0, 0)
+		SHA256NI_RNDS4(m1, 4)
+		m0 = _mm_sha256msg1_epu32(m0, m1);
+		SHA256NI_RNDS4(m2, 8)
+		m1 = _mm_sha256msg1_epu32(m1, m2);
+		SHA256NI_GROUP(m3, m0, m2, 12)
+		SHA256NI_GROUP(m0, m1, m3, 16)
+		SHA256NI_GROUP(m1, m2, m0, 20)
+		SHA256NI_GROUP(m2, m3, m1, 24)
+		SHA256NI_GROUP(m3, m0, m2, 28)
+		SHA256NI_GROUP(m0, m1, m3, 32)
+		SHA256NI_GROUP(m1, m2, m0, 36)
+		SHA256NI_GROUP(m2, m3, m1, 40)
+		SHA256NI_GROUP(m3, m0, m2, 44)
+		SHA256NI_GROUP(m0, m1, m3, 48)
+		SHA256NI_RNDS4(m1, 52)
+		m2 = _mm_sha256msg2_epu32(_mm_add_epi32(m2, _mm_alignr_epi8(m1, m0, 4)), m1);
+		SHA256NI_RNDS4(m2, 56)
+		m3 = _mm_sha256msg2_epu32(_mm_add_epi32(m3, _mm_alignr_epi8(m2, m1, 4)), m2);
+		SHA256NI_RNDS4(m3, 60)
+
+		abef = _mm_add_epi32(abef, abefSave);
+		cdgh = _mm_add_epi32(cdgh, cdghSave);
+
+		data += 64;
+	}
+
+	t = _mm_shuffle_epi32(abef, 0x1b);		//feba
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);		//dchg
+	_mm_storeu_si128((__m128i *) state, _mm_blend_epi16(t, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i *) (state + 4), _mm_alignr_epi8(cdgh, t, 8));
+}
+
+#endif
+
+//----------------------------------------------------------------------
+//runtime dispatch
+
+typedef void (*blocksFunc)(hl_uint32 *state, const hl_uint8 *data, size_t blocks);
+typedef void (*blocks8Func)(hl_uint32 state[][8], const hl_uint8 *ptr[8], const size_t step[8], size_t blocks);
+
+struct multihashImpl
+{
+	blocks8Func md5x8 = nullptr;
+	blocks8Func sha1x8 = nullptr;
+	blocks8Func sha256x8 = nullptr;
+	blocksFunc sha1 = sha1Blocks;
+	blocksFunc sha256 = sha256Blocks;
+	char name[64] = "md5: scalar, sha1: scalar, sha256: scalar";
+
+	multihashImpl()
+	{
+#ifdef HL_MULTIHASH_X86
+		bool avx2 = false, sha = false, sse41 = false, ssse3 = false;
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+		__cpuid(info, 1);
+		bool ymm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+		ssse3 = (info[2] & (1 << 9)) != 0;
+		sse41 = (info[2] & (1 << 19)) != 0;
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = ymm && (info[1] & (1 << 5));
+			sha = (info[1] & (1 << 29)) != 0;
+		}
+#else
+		unsigned int eax, ebx, ecx, edx;
+		if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		{
+			bool ymm = false;
+			if ((ecx & (1 << 27)) && (ecx & (1 << 28)))
+			{
+				unsigned int xcr0, xcr0h;
+				__asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0h) : "c" (0));
+				ymm = (xcr0 & 6) == 6;
+			}
+			ssse3 = (ecx & (1 << 9)) != 0;
+			sse41 = (ecx & (1 << 19)) != 0;
+			if (__get_cpuid_max(0, nullptr) >= 7)
+			{
+				__cpuid_count(7, 0, eax, ebx, ecx, edx);
+				avx2 = ymm && (ebx & (1 << 5));
+				sha = (ebx & (1 << 29)) != 0;
+			}
+		}
+#endif
+		//one sha-ni stream is faster than 8 avx2 lanes, sha-ni wins when available
+		if (sha && sse41 && ssse3)
+		{
+			sha1 = sha1BlocksNi;
+			sha256 = sha256BlocksNi;
+		}
+		else if (avx2)
+		{
+			sha1x8 = sha1Blocks8;
+			sha256x8 = sha256Blocks8;
+		}
+		if (avx2)
+		{
+			md5x8 = md5Blocks8;
+		}
+
+		const char *md5Name = md5x8 ? "avx2 x8" : "scalar";
+		const char *shaName = sha1 != sha1Blocks ? "sha-ni" : sha1x8 ? "avx2 x8" : "scalar";
+		snprintf(name, sizeof(name), "md5: %s, sha1: %s, sha256: %s", md5Name, shaName, shaName);
+#endif
+	}
+};
+
+static const multihashImpl &getImpl()
+{
+	static const multihashImpl impl;
+	return impl;
+}
+
+/**
+ *  @brief 	Process "slice[i]" blocks of each lane with a 8 lanes kernel,
+ *  		lanes which are done (or unused) read a zero block
+ *  		and their result is dropped
+ */
+static void runLanes8(blocks8Func kernel, blocksFunc single, int words,
+		      hl_uint32 **states, const hl_uint8 **ptr, size_t *slice, int count)
+{
+	hl_uint32 state[8][8];
+	const hl_uint8 *lanePtr[8];
+	size_t step[8];
+
+	for (;;)
+	{
+		int active = 0, last = 0;
+		size_t blocks = 0;
+		for (int l = 0; l < count; l++)
+		{
+			if (slice[l] > 0)
+			{
+				blocks = active == 0 || slice[l] < blocks ? slice[l] : blocks;
+				last = l;
+				active++;
+			}
+		}
+		if (active == 0)
+		{
+			return;
+		}
+		if (active == 1)
+		{
+			single(states[last], ptr[last], slice[last]);
+			ptr[last] += slice[last] * 64;
+			slice[last] = 0;
+			return;
+		}
+
+		for (int l = 0; l < 8; l++)
+		{
+			bool used = l < count && slice[l] > 0;
+			for (int i = 0; i < words; i++)
+			{
+				state[i][l] = used ? states[l][i] : 0;
+			}
+			lanePtr[l] = used ? ptr[l] : zeroBlock;
+			step[l] = used ? 64 : 0;
+		}
+
+		kernel(state, lanePtr, step, blocks);
+
+		for (int l = 0; l < count; l++)
+		{
+			if (slice[l] > 0)
+			{
+				for (int i = 0; i < words; i++)
+				{
+					states[l][i] = state[i][l];
+				}
+				ptr[l] += blocks * 64;
+				slice[l] -= blocks;
+			}
+		}
+	}
+}
+
+/**
+ *  @brief 	Process "slice[i]" blocks of one digest for each context,
+ *  		with the 8 lanes kernel when several lanes are used
+ */
+static void processDigest(blocks8Func kernel, blocksFunc single, int words,
+			  hl_uint32 **states, const hl_uint8 **ptr, size_t *slice, int count)
+{
+	int lanes = 0;
+	for (int i = 0; i < count; i++)
+	{
+		lanes += slice[i] > 0 ? 1 : 0;
+	}
+
+	if (kernel && lanes > 1)
+	{
+		runLanes8(kernel, single, words, states, ptr, slice, count);
+	}
+	else
+	{
+		for (int i = 0; i < count; i++)
+		{
+			single(states[i], ptr[i], slice[i]);
+		}
+	}
+}
+
+/**
+ *  @brief 	Process "blocks[i]" full blocks at "data[i]" for each context
+ */
+static void processBlocks(HL_MULTIHASH_CTX *const *contexts, const hl_uint8 **data, size_t *blocks, int count)
+{
+	const multihashImpl &impl = getImpl();
+
+	for (;;)
+	{
+		hl_uint32 *md5[HL_MULTIHASH_LANES], *sha1[HL_MULTIHASH_LANES], *sha256[HL_MULTIHASH_LANES];
+		const hl_uint8 *ptr[HL_MULTIHASH_LANES];
+		size_t slice[HL_MULTIHASH_LANES];
+		size_t sliceBlocks[HL_MULTIHASH_LANES];
+		bool done = true;
+
+		for (int i = 0; i < count; i++)
+		{
+			sliceBlocks[i] = blocks[i] < HL_MULTIHASH_SLICE ? blocks[i] : HL_MULTIHASH_SLICE;
+			done = done && sliceBlocks[i] == 0;
+			md5[i] = contexts[i]->md5;
+			sha1[i] = contexts[i]->sha1;
+			sha256[i] = contexts[i]->sha256;
+		}
+		if (done)
+		{
+			return;
+		}
+
+		const struct
+		{
+			int flag;
+			hl_uint32 **states;
+			blocks8Func kernel;
+			blocksFunc single;
+			int words;
+		} digests[] =
+		{
+			{ HL_MULTIHASH_MD5, md5, impl.md5x8, md5Blocks, 4 },
+			{ HL_MULTIHASH_SHA1, sha1, impl.sha1x8, impl.sha1, 5 },
+			{ HL_MULTIHASH_SHA256, sha256, impl.sha256x8, impl.sha256, 8 }
+		};
+
+		for (const auto &digest : digests)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				ptr[i] = data[i];
+				slice[i] = (contexts[i]->digests & digest.flag) ? sliceBlocks[i] : 0;
+			}
+			processDigest(digest.kernel, digest.single, digest.words, digest.states, ptr, slice, count);
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			data[i] += sliceBlocks[i] * 64;
+			blocks[i] -= sliceBlocks[i];
+		}
+	}
+}
+
+//----------------------------------------------------------------------
+//public member functions
+
+void multihash::init(HL_MULTIHASH_CTX *context, int digests)
+{
+	memset(context, 0, sizeof(HL_MULTIHASH_CTX));
+	context->digests = digests;
+
+	context->md5[0] = 0x67452301;
+	context->md5[1] = 0xefcdab89;
+	context->md5[2] = 0x98badcfe;
+	context->md5[3] = 0x10325476;
+
+	context->sha1[0] = 0x67452301;
+	context->sha1[1] = 0xefcdab89;
+	context->sha1[2] = 0x98badcfe;
+	context->sha1[3] = 0x10325476;
+	context->sha1[4] = 0xc3d2e1f0;
+
+	memcpy(context->sha256, sha256Init, sizeof(sha256Init));
+}
+
+void multihash::update(HL_MULTIHASH_CTX *const *contexts,
+		       const hl_uint8 *const *data,
+		       const unsigned long *length,
+		       int count)
+{
+	while (count > HL_MULTIHASH_LANES)
+	{
+		update(contexts, data, length, HL_MULTIHASH_LANES);
+		contexts += HL_MULTIHASH_LANES;
+		data += HL_MULTIHASH_LANES;
+		length += HL_MULTIHASH_LANES;
+		count -= HL_MULTIHASH_LANES;
+	}
+
+	HL_MULTIHASH_CTX *single[1];
+	const hl_uint8 *ptr[HL_MULTIHASH_LANES];
+	size_t blocks[HL_MULTIHASH_LANES];
+
+	for (int i = 0; i < count; i++)
+	{
+		HL_MULTIHASH_CTX *ctx = contexts[i];
+		const hl_uint8 *p = data[i];
+		size_t len = length[i];
+		ctx->length += len;
+
+		//complete the pending block first
+		if (ctx->bufferLength > 0)
+		{
+			size_t n = 64 - ctx->bufferLength < len ? 64 - ctx->bufferLength : len;
+			memcpy(ctx->buffer + ctx->bufferLength, p, n);
+			ctx->bufferLength += (unsigned int) n;
+			p += n;
+			len -= n;
+			if (ctx->bufferLength < 64)
+			{
+				ptr[i] = p;
+				blocks[i] = 0;
+				continue;
+			}
+			const hl_uint8 *pending = ctx->buffer;
+			size_t one = 1;
+			single[0] = ctx;
+			processBlocks(single, &pending, &one, 1);
+			ctx->bufferLength = 0;
+		}
+
+		//full blocks are processed below (all lanes together), keep the tail
+		ptr[i] = p;
+		blocks[i] = len / 64;
+		ctx->bufferLength = (unsigned int) (len % 64);
+		memcpy(ctx->buffer, p + blocks[i] * 64, ctx->bufferLength);
+	}
+
+	processBlocks(contexts, ptr, blocks, count);
+}
+
+void multihash::update(HL_MULTIHASH_CTX *context, const hl_uint8 *data, unsigned long length)
+{
+	update(&context, &data, &length, 1);
+}
+
+void multihash::final(HL_MULTIHASH_CTX *context, hl_uint8 *md5, hl_uint8 *sha1, hl_uint8 *sha256)
+{
+	hl_uint8 pad[128];
+	hl_uint64 bits = context->length * 8;
+	size_t len = context->bufferLength;
+
+	memcpy(pad, context->buffer, len);
+	pad[len++] = 0x80;
+	size_t total = len <= 56 ? 64 : 128;
+	memset(pad + len, 0, total - len);
+
+	if (md5 && (context->digests & HL_MULTIHASH_MD5))
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			pad[total - 8 + i] = (hl_uint8) (bits >> (8 * i));
+		}
+		md5Blocks(context->md5, pad, total / 64);
+		for (int i = 0; i < 4; i++)
+		{
+			storeLE32(md5 + i * 4, context->md5[i]);
+		}
+	}
+
+	//sha1 and sha256 share the big endian length
+	for (int i = 0; i < 8; i++)
+	{
+		pad[total - 1 - i] = (hl_uint8) (bits >> (8 * i));
+	}
+
+	if (sha1 && (context->digests & HL_MULTIHASH_SHA1))
+	{
+		getImpl().sha1(context->sha1, pad, total / 64);
+		for (int i = 0; i < 5; i++)
+		{
+			storeBE32(sha1 + i * 4, context->sha1[i]);
+		}
+	}
+
+	if (sha256 && (context->digests & HL_MULTIHASH_SHA256))
+	{
+		getImpl().sha256(context->sha256, pad, total / 64);
+		for (int i = 0; i < 8; i++)
+		{
+			storeBE32(sha256 + i * 4, context->sha256[i]);
+		}
+	}
+}
+
+const char *multihash::getImplementation(void)
+{
+	return getImpl().name;
+}
+
+//----------------------------------------------------------------------
+//EOF
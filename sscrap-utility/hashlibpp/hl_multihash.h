@@ -0,0 +1,122 @@
+/*
+ * hashlib++ - a simple hash library for C++
+ *
+ * multi-buffer extension: md5/sha1/sha256 of several independent messages at once
+ */
+
+//----------------------------------------------------------------------
+
+/**
+ *  @file 	hl_multihash.h
+ *  @brief	This file contains the declaration of the multihash class
+ *  @date 	Fr 16 Oct 2026
+ */
+
+//----------------------------------------------------------------------
+//include protection
+#ifndef HL_MULTIHASH_H
+#define HL_MULTIHASH_H
+
+//----------------------------------------------------------------------
+//STL includes
+#include <cstddef>
+
+//----------------------------------------------------------------------
+//hl includes
+#include "hl_types.h"
+
+//----------------------------------------------------------------------
+//defines
+#define HL_MULTIHASH_MD5	0x01
+#define HL_MULTIHASH_SHA1	0x02
+#define HL_MULTIHASH_SHA256	0x04
+
+#define HL_MULTIHASH_LANES	8
+
+//----------------------------------------------------------------------
+//structs
+
+/**
+ * @brief this struct represents the hash context of one message.
+ *        md5, sha1 and sha256 share the same 64 bytes block framing,
+ *        so a single pending block buffer is used for all digests.
+ */
+typedef struct
+{
+	int digests;			//!< HL_MULTIHASH_* flags
+	hl_uint32 md5[4];		//!< md5 state
+	hl_uint32 sha1[5];		//!< sha1 state
+	hl_uint32 sha256[8];		//!< sha256 state
+	hl_uint64 length;		//!< message length in bytes
+	hl_uint8 buffer[64];		//!< pending (partial) block
+	unsigned int bufferLength;	//!< bytes in buffer
+} HL_MULTIHASH_CTX;
+
+//----------------------------------------------------------------------
+//class definition
+
+/**
+ *  @brief 	This class computes md5, sha1 and/or sha256 digests of up
+ *  		to HL_MULTIHASH_LANES messages together.
+ *
+ *  		Full blocks of the messages are interleaved in simd lanes
+ *  		(avx2, 8 x 32 bits) when the cpu supports it, sha1 and sha256
+ *  		use the sha extensions (sha-ni) when available. Otherwise blocks are
+ *  		processed by portable scalar code. The implementation is
+ *  		selected once, at runtime.
+ */
+class multihash
+{
+	public:
+
+		/**
+		 *  @brief 	Initialize a context
+		 *  @param	context The context to initialize
+		 *  @param	digests HL_MULTIHASH_MD5, HL_MULTIHASH_SHA1
+		 *  		and/or HL_MULTIHASH_SHA256
+		 */
+		static void init(HL_MULTIHASH_CTX *context, int digests);
+
+		/**
+		 *  @brief 	Add data to several contexts at once
+		 *  @param	contexts The contexts to update (distinct messages)
+		 *  @param	data The data to add to each context
+		 *  @param	length The length of the data for each context
+		 *  @param	count The number of contexts (HL_MULTIHASH_LANES max)
+		 */
+		static void update(HL_MULTIHASH_CTX *const *contexts,
+				   const hl_uint8 *const *data,
+				   const unsigned long *length,
+				   int count);
+
+		/**
+		 *  @brief 	Add data to one context
+		 */
+		static void update(HL_MULTIHASH_CTX *context,
+				   const hl_uint8 *data,
+				   unsigned long length);
+
+		/**
+		 *  @brief 	Finalize a context and get the digests
+		 *  @param	context The context to finalize
+		 *  @param	md5 16 bytes md5 digest (can be NULL)
+		 *  @param	sha1 20 bytes sha1 digest (can be NULL)
+		 *  @param	sha256 32 bytes sha256 digest (can be NULL)
+		 */
+		static void final(HL_MULTIHASH_CTX *context,
+				  hl_uint8 *md5, hl_uint8 *sha1,
+				  hl_uint8 *sha256 = NULL);
+
+		/**
+		 *  @brief 	Name of the selected implementations
+		 *  		(ie: "md5: avx2 x8, sha1: sha-ni, sha256: sha-ni")
+		 */
+		static const char *getImplementation(void);
+};
+
+//----------------------------------------------------------------------
+//end of include protection
+#endif
+
+//----------------------------------------------------------------------
+//EOF
@@ -2,6 +2,8 @@
 // Created by cpasjuste on 29/03/19.
 //
 
+#include <set>
+#include <algorithm>
 #include "ss_api.h"
 #include "scrap.h"
 #include "args.h"
@@ -10,7 +12,11 @@
 using namespace ss_api;
 
 static Scrap *scrap;
-static int retryDelay = 10;
+static bool retry = true;
+
+// systems and medias types lists cache expiration (seconds)
+#define SS_LISTS_TTL (24 * 60 * 60)
+#define SS_HASHCACHE_FILE ".sscrap_hashes"
 
 static void fixFbnGame(Game *ssGame, Game *fbnGame) {
     // game not found in fbneo dat, continue...
@@ -30,22 +36,15 @@ static void fixFbnGame(Game *ssGame, Game *fbnGame) {
 }
 
 ss_api::Game *Scrap::getGameByParent(const Io::File &file) {
-    const std::string name = file.name;
-    auto clone = std::find_if(fbnGameList.games.begin(), fbnGameList.games.end(), [name](const Game &g) {
-        return name == g.path;
-    });
-
-    if (clone == fbnGameList.games.end() || !clone->isClone()) {
+    Game *clone = fbnGameList.getGameByPath(file.name);
+    if (clone == nullptr || !clone->isClone()) {
         SS_PRINT("getGameByParent: clone game not found (%s)\n", file.name.c_str());
         return nullptr;
     }
 
     const std::string parentPath = clone->cloneOf + ".zip";
-    auto parent = std::find_if(gameList.games.begin(), gameList.games.end(), [parentPath](const Game &g) {
-        return parentPath == g.path;
-    });
-
-    if (parent == gameList.games.end()) {
+    Game *parent = gameList.getGameByPath(parentPath);
+    if (parent == nullptr) {
         SS_PRINT("getGameByParent: parent game not found for %s (%s)\n", file.name.c_str(), clone->cloneOf.c_str());
         return nullptr;
     }
@@ -66,12 +65,8 @@ ss_api::Game *Scrap::getGameByParent(const Io::File &file) {
 }
 
 bool Scrap::isFbnClone(const Io::File &file) {
-    const std::string name = file.name;
-    auto game = std::find_if(fbnGameList.games.begin(), fbnGameList.games.end(), [name](const Game &g) {
-        return name == g.path;
-    });
-
-    return game != gameList.games.end() && game->isClone();
+    Game *game = fbnGameList.getGameByPath(file.name);
+    return game != nullptr && game->isClone();
 }
 
 // if a custom sscrap custom id is set (fbneo console games),
@@ -165,7 +160,7 @@ ss_api::Game Scrap::scrapGame(int tid, int tryCount, int sid, int remainingFiles
     // first, search by zip crc
     fileCrc = Api::getFileCrc(filePath);
     gameInfo = GameInfo(fileCrc, "", "", std::to_string(sid), romType,
-                        fileName, "", "", usr, pwd, retryDelay);
+                        fileName, "", "", usr, pwd, retry);
     if (gameInfo.http_error == 0) {
         searchType = "file_crc";
     } else if (gameInfo.http_error == 430 || gameInfo.http_error == 431 || gameInfo.http_error == 500) {
@@ -181,7 +176,7 @@ ss_api::Game Scrap::scrapGame(int tid, int tryCount, int sid, int remainingFiles
         romCrc = Utility::getRomCrc(filePath);
         if (!romCrc.empty()) {
             gameInfo = GameInfo(romCrc, "", "", std::to_string(sid), romType,
-                                fileName, "", "", usr, pwd, retryDelay);
+                                fileName, "", "", usr, pwd, retry);
             if (gameInfo.http_error == 0) {
                 searchType = "rom_crc";
             } else if (gameInfo.http_error == 430 || gameInfo.http_error == 431 || gameInfo.http_error == 500) {
@@ -209,7 +204,7 @@ ss_api::Game Scrap::scrapGame(int tid, int tryCount, int sid, int remainingFiles
         if (pos != std::string::npos && pos > 2) {
             name = name.substr(0, pos - 1);
         }
-        GameSearch search = GameSearch(name, std::to_string(sid), usr, pwd, retryDelay);
+        GameSearch search = GameSearch(name, std::to_string(sid), usr, pwd, retry);
         SS_PRINT("game_search: %s, res = %i\n", name.c_str(), gameInfo.http_error);
         if (!search.games.empty()) {
             int id = sid;
@@ -241,7 +236,10 @@ ss_api::Game Scrap::scrapGame(int tid, int tryCount, int sid, int remainingFiles
             // if rom media was already scrapped for a same "screenscraper game", use it
             // this is useful for non arcade roms for which clone notion doesn't exist
             if (!args.exist("-c")) {
+                // the game list is appended by other threads
+                pthread_mutex_lock(&mutex);
                 std::vector<Game> clones = gameList.findGamesByName(gameInfo.game.name);
+                pthread_mutex_unlock(&mutex);
                 for (const auto &clone: clones) {
                     if (!clone.medias.empty()) {
                         gameInfo.game.medias = clone.medias;
@@ -268,6 +266,7 @@ ss_api::Game Scrap::scrapGame(int tid, int tryCount, int sid, int remainingFiles
                     Io::makedir(mediaPath);
                 }
 
+                std::vector<std::future<int>> downloads;
                 std::vector<std::string> mediaArgs = {
                         args.get("-i"),
                         args.get("-t"),
@@ -325,7 +324,12 @@ ss_api::Game Scrap::scrapGame(int tid, int tryCount, int sid, int remainingFiles
                         }
                     }
 
-                    media.download(path + mediaName);
+                    downloads.emplace_back(media.downloadAsync(path + mediaName));
+                }
+
+                // wait for medias to be downloaded
+                for (auto &download: downloads) {
+                    download.wait();
                 }
             }
         }
@@ -432,7 +436,7 @@ static void *scrap_thread(void *ptr) {
         // add the game to game list
         if (game.id > 0) {
             pthread_mutex_lock(&scrap->mutex);
-            scrap->gameList.games.emplace_back(game);
+            scrap->gameList.add(game);
             pthread_mutex_unlock(&scrap->mutex);
         }
     }
@@ -452,6 +456,18 @@ Scrap::Scrap(const ArgumentParser &parser) {
     Api::ss_devpassword = SS_DEV_PWD;
 #endif
     Api::ss_softname = "sscrap";
+    if (args.exist("-url")) {
+        Api::ss_baseurl = args.get("-url");
+        if (!Api::ss_baseurl.empty() && Api::ss_baseurl.back() != '/') {
+            Api::ss_baseurl += "/";
+        }
+    }
+    // local jeuInfos responses cache (ttl in days)
+    if (args.exist("-cache")) {
+        long ttl = Utility::parseInt(args.get("-cachettl"), 30);
+        long negativeTtl = Utility::parseInt(args.get("-cachenegttl"), 7);
+        Cache::setup(args.get("-cache"), ttl * 86400, negativeTtl * 86400);
+    }
     ss_debug = args.exist("-d");
 
     usr = args.get("-u");
@@ -466,23 +482,272 @@ Scrap::Scrap(const ArgumentParser &parser) {
     Api::printc(COLOR_G, "        \\/        \\/         \\/       \\/ 2020 @ cpasjuste\n\n");
 
     if (!args.tokens.empty() && !args.exist("-zi")) {
+        // user information (quotas) is always needed, get it while systems and medias lists are loaded
         Api::printc(COLOR_G, "Getting user information... ");
-        user = User(usr, pwd);
+        std::thread userThread([this] {
+            user = User(usr, pwd);
+        });
+
+        // systems and medias types lists are cached, a stale copy is used while it's refreshed in background
+        // (in "-cache" directory, else in the user cache directory, not cached if there is none)
+        std::string cachePath = args.exist("-cache") ? args.get("-cache") : Utility::getUserCachePath();
+        if (!cachePath.empty() && !Io::exist(cachePath)) {
+            Io::makedir(cachePath);
+        }
+        // lists are keyed by server, a mirror (-url) may not serve the same systems or medias
+        std::string systemsPath, mediasPath;
+        if (!cachePath.empty()) {
+            char key[32];
+            snprintf(key, sizeof(key), "%zx", std::hash<std::string>()(Api::ss_baseurl));
+            systemsPath = cachePath + "/systems_" + key + ".list";
+            mediasPath = cachePath + "/medias_" + key + ".list";
+        }
+        bool systemsExpired = false, mediasExpired = false;
+        bool systemsCached = !systemsPath.empty() && systemList.load(systemsPath, SS_LISTS_TTL, &systemsExpired);
+        if (!systemsCached) {
+            systemList = SystemList(usr, pwd, retry);
+            if (!systemsPath.empty() && systemList.http_error == 0 && !systemList.systems.empty()) {
+                systemList.save(systemsPath);
+            }
+        }
+        bool mediasCached = !mediasPath.empty() && mediasGameList.load(mediasPath, SS_LISTS_TTL, &mediasExpired);
+        if (!mediasCached) {
+            mediasGameList = MediasGameList(usr, pwd, retry);
+            if (!mediasPath.empty() && mediasGameList.http_error == 0 && !mediasGameList.medias.empty()) {
+                mediasGameList.save(mediasPath);
+            }
+        }
+
+        userThread.join();
         Api::printc(COLOR_G, "found user %s, threads: %s, requests: %s/%s, download speed: %s Ko/s\n",
                     user.id.c_str(), user.maxthreads.c_str(),
                     user.requeststoday.c_str(), user.maxrequestsperday.c_str(),
                     user.maxdownloadspeed.c_str());
+        // pace all following requests to the user quotas
+        if (user.http_error == 0) {
+            RateLimiter::setup(user);
+        }
 
         Api::printc(COLOR_G, "Updating systems... ");
-        systemList = SystemList(usr, pwd, retryDelay);
-        Api::printc(COLOR_G, "found %zu systems\n", systemList.systems.size());
+        Api::printc(COLOR_G, "found %zu systems%s\n", systemList.systems.size(), systemsCached ? " (cached)" : "");
 
         Api::printc(COLOR_G, "Updating medias types... ");
-        mediasGameList = MediasGameList(usr, pwd, retryDelay);
-        Api::printc(COLOR_G, "found %zu medias type\n", mediasGameList.medias.size());
+        Api::printc(COLOR_G, "found %zu medias type%s\n", mediasGameList.medias.size(), mediasCached ? " (cached)" : "");
+
+        if (user.http_error == 0 && (systemsExpired || mediasExpired)) {
+            refreshThread = std::thread([this, systemsPath, mediasPath, systemsExpired, mediasExpired] {
+                if (systemsExpired) {
+                    SystemList list(usr, pwd, retry);
+                    if (list.http_error == 0 && !list.systems.empty()) {
+                        list.save(systemsPath);
+                    }
+                }
+                if (mediasExpired) {
+                    MediasGameList list(usr, pwd, retry);
+                    if (list.http_error == 0 && !list.medias.empty()) {
+                        list.save(mediasPath);
+                    }
+                }
+            });
+        }
+    }
+}
+
+Scrap::~Scrap() {
+    // wait for lists background refresh
+    if (refreshThread.joinable()) {
+        refreshThread.join();
+    }
+}
+
+void Scrap::scrapFiles() {
+    // if fbneo/mame system filter clones to process them later with parent game
+    cloneList.clear();
+    if (isFbNeoSid) {
+        for (int i = filesCount - 1; i > -1; i--) {
+            if (isFbnClone(filesList.at(i))) {
+                cloneList.push_back(filesList.at(i));
+                filesList.erase(filesList.begin() + i);
+            }
+        }
+        Api::printc(COLOR_G, "Skipped %i clones, will use parent information...\n\n", cloneList.size());
+    }
+
+    pthread_mutex_init(&mutex, nullptr);
+    int maxThreads = user.getMaxThreads();
+
+    // requests (and medias downloads) concurrency is limited by user "maxthreads"
+    CurlMulti::start(maxThreads);
+
+    for (int i = 0; i < maxThreads; i++) {
+        pthread_create(&threads[i], nullptr, scrap_thread, &i);
+    }
+
+    for (int i = 0; i < maxThreads; i++) {
+        pthread_join(threads[i], nullptr);
+    }
+
+    pthread_mutex_destroy(&mutex);
+    CurlMulti::stop();
+
+    // if fbneo/mame system process clones now based on parent game
+    if (isFbNeoSid) {
+        Api::printc(COLOR_G, "\nPlease wait, processing clones...\n");
+        for (auto &clone: cloneList) {
+            Game *game = getGameByParent(clone);
+            if (game) {
+                gameList.add(*game);
+            } else {
+                // game was not found, parent was probably not scrapped...
+                // TODO:
+                Api::printc(COLOR_Y, "\t%s: parent rom not scrapped/available, skipping...\n",
+                            clone.name.c_str());
+            }
+        }
+    }
+}
+
+void Scrap::save(size_t keptGames) {
+    if (!gameList.games.empty()) {
+        // save gamelist.xml
+        gameList.save(romPath + "/gamelist.xml", args.get("-i"), args.get("-t"), args.get("-v"));
+    }
+
+    // print results
+    FILE *f = fopen("sscrap.log", "w+");
+    Api::printc(COLOR_G, "\nAll Done... ");
+    Api::printc(COLOR_G, "found %zu/%i games\n", gameList.games.size() - missList.size(),
+                filesCount + (int) keptGames);
+    Curl::Transfer transfer = Curl::getTotal();
+    Api::printc(COLOR_G, "Downloaded %.2f MB (%.2f MB uncompressed)\n",
+                (double) transfer.wireSize / (1024 * 1024), (double) transfer.size / (1024 * 1024));
+    if (f) {
+        fprintf(f, "Found %zu/%i games\n", gameList.games.size() - missList.size(),
+                filesCount + (int) keptGames);
+    }
+    if (!missList.empty()) {
+        Api::printc(COLOR_O, "\n%zu game(s) not found:\n", missList.size());
+        if (f) {
+            fprintf(f, "\n%zu game(s) not found:\n", missList.size());
+        }
+        // hash all missing roms together
+        std::vector<std::string> missFiles;
+        for (const auto &miss: missList) {
+            missFiles.push_back(miss.path);
+        }
+        std::vector<Utility::ZipInfo> missInfos = Utility::getZipInfos(romPath + "/", missFiles);
+        for (size_t i = 0; i < missList.size(); i++) {
+            std::string missInfo = Utility::getZipInfoStr(missInfos[i]);
+            Api::printc(COLOR_R, "%s (%s)\n", missInfo.c_str(), missList[i].name.c_str());
+            if (f) {
+                fprintf(f, "%s\n", missInfo.c_str());
+            }
+        }
+    }
+    HashCache::save();
+    if (!snapshotPath.empty() && !gameList.games.empty()) {
+        // files which didn't make it to the game list (quota reached...) are processed again next time
+        std::set<std::string> paths;
+        for (const auto &game: gameList.games) {
+            paths.insert(game.path);
+        }
+        Snapshot saved = snapshot;
+        saved.entries.erase(std::remove_if(saved.entries.begin(), saved.entries.end(),
+                                           [&paths](const Snapshot::Entry &entry) {
+                                               return paths.count(entry.name.substr(entry.name.rfind('/') + 1)) == 0;
+                                           }), saved.entries.end());
+        saved.save(snapshotPath, romPath);
+    }
+    printf("\n");
+    if (f) {
+        fclose(f);
     }
 }
 
+void Scrap::watch(Watcher &watcher) {
+    Api::printc(COLOR_G, "Watching '%s' for new roms (ctrl+c to quit)...\n\n", romPath.c_str());
+
+    Watcher::Changes changes;
+    while (watcher.wait(&changes)) {
+        // snapshot names (relative to the roms folder)
+        std::vector<std::string> removed;
+        std::set<std::string> changed;
+        if (changes.rescan) {
+            // some events were lost, compare with a new listing
+            Snapshot current;
+            if (!current.scan(romPath, recursive, filters)) {
+                continue;
+            }
+            Snapshot::Diff diff = snapshot.diff(current);
+            removed = diff.removed;
+            changed.insert(diff.added.begin(), diff.added.end());
+            changed.insert(diff.modified.begin(), diff.modified.end());
+        } else {
+            std::set<std::string> names;
+            for (const auto &path: changes.removed) {
+                // a removed directory files are taken from the snapshot
+                std::string name = path.substr(romPath.size() + 1);
+                std::vector<std::string> dirNames = snapshot.getNames(name);
+                if (dirNames.empty()) {
+                    names.insert(name);
+                } else {
+                    names.insert(dirNames.begin(), dirNames.end());
+                }
+            }
+            removed.assign(names.begin(), names.end());
+            for (const auto &path: changes.changed) {
+                // skip our own renames (dreamcast disc.gdi) and files already scrapped
+                std::string name = path.substr(romPath.size() + 1);
+                if (!snapshot.isUnchanged(romPath, name)) {
+                    changed.insert(name);
+                }
+            }
+        }
+
+        // list the changed files directories, for dreamcast titles
+        std::set<std::string> dirs;
+        for (const auto &name: changed) {
+            size_t sep = name.rfind('/');
+            dirs.insert(sep != std::string::npos ? romPath + "/" + name.substr(0, sep) : romPath);
+        }
+        filesList.clear();
+        for (const auto &dir: dirs) {
+            for (auto &file: Io::getDirList(dir, false, filters)) {
+                if (changed.count(Snapshot::getName(romPath, file)) > 0) {
+                    filesList.push_back(std::move(file));
+                }
+            }
+        }
+        snapshot.update(romPath, filesList, removed);
+
+        // removed and changed files games are dropped, changed files are scrapped again
+        std::set<std::string> dropped;
+        for (const auto &name: removed) {
+            dropped.insert(name.substr(name.rfind('/') + 1));
+        }
+        for (const auto &file: filesList) {
+            dropped.insert(file.name);
+        }
+        size_t count = gameList.games.size();
+        gameList.games.erase(std::remove_if(gameList.games.begin(), gameList.games.end(),
+                                            [&dropped](const Game &game) {
+                                                return dropped.count(game.path) > 0;
+                                            }), gameList.games.end());
+        if (filesList.empty() && gameList.games.size() == count) {
+            continue;
+        }
+
+        Api::printc(COLOR_G, "%zu roms changed, %zu removed\n\n", filesList.size(), removed.size());
+        size_t keptGames = gameList.games.size();
+        filesCount = (int) filesList.size();
+        missList.clear();
+        scrapFiles();
+        save(keptGames);
+    }
+
+    Api::printc(COLOR_R, "ERROR: rom path watch failed\n");
+}
+
 void Scrap::run() {
     if (user.http_error == 430 || user.http_error == 431 || user.http_error == 500) {
         Api::printc(COLOR_R, "NOK: Quota reached for today... "
@@ -509,95 +774,78 @@ void Scrap::run() {
 
     if (args.exist("-r")) {
         romPath = args.get("-r");
+        // files hashes are kept in the roms folder, unchanged files are not hashed again
+        if (!args.exist("-nohashcache")) {
+            HashCache::setup(romPath + "/" + SS_HASHCACHE_FILE);
+        }
         Api::printc(COLOR_G, "Building roms list... ");
-        std::vector<std::string> filters = {".zip"};
+        filters = {".zip"};
         if (args.exist("-filter")) {
             filters = {args.get("-filter")};
         }
-        if (system.id == SYSTEM_ID_DREAMCAST) {
-            filesList = Io::getDirList(romPath, true, {".gdi"});
+        recursive = system.id == SYSTEM_ID_DREAMCAST;
+        if (recursive) {
+            filters = {".gdi"};
+        }
+        // started before the listing, so roms landing while scrapping are not missed
+        Watcher watcher(romPath, recursive, filters);
+        if (args.exist("-w") && !watcher.start()) {
+            Api::printc(COLOR_R, "ERROR: could not watch rom path\n");
+            return;
+        }
+        // with "-inc" or "-w", the listing (with files size and mtime) is saved after scrapping,
+        // to only process changes. else files are only listed (not stat'ed) and no snapshot is written
+        if (args.exist("-inc") || args.exist("-w")) {
+            snapshotPath = romPath + "/" + SS_SNAPSHOT_FILE;
+            snapshot.scan(romPath, recursive, filters, &filesList);
         } else {
-            filesList = Io::getDirList(romPath, false, filters);
+            filesList = Io::getDirList(romPath, recursive, filters);
         }
         filesCount = (int) filesList.size();
 
         Api::printc(COLOR_G, "found %zu roms\n", filesCount);
-        if (filesList.empty()) {
+        if (filesList.empty() && !args.exist("-w")) {
             Api::printc(COLOR_R, "ERROR: no files found in rom path\n");
             return;
         }
 
-        //SystemList::System system = systemList.findById(std::to_string(systemId));
-        Api::printc(COLOR_G, "Scrapping system '%s', let's go!\n\n", system.name.c_str());
-
-        // if fbneo/mame system filter clones to process them later with parent game
-        if (isFbNeoSid) {
-            for (int i = filesCount - 1; i > -1; i--) {
-                if (isFbnClone(filesList.at(i))) {
-                    cloneList.push_back(filesList.at(i));
-                    filesList.erase(filesList.begin() + i);
-                }
+        size_t keptGames = 0;
+        Snapshot previous;
+        if (args.exist("-inc") && previous.load(snapshotPath)
+            && previous.recursive == recursive && previous.filters == filters
+            && gameList.append(romPath + "/gamelist.xml", "", false)) {
+            Snapshot::Diff diff = previous.diff(snapshot);
+            // removed and modified files games are dropped, added and modified files are scrapped
+            std::set<std::string> changed(diff.modified.begin(), diff.modified.end());
+            std::set<std::string> dropped;
+            for (const auto &name: changed) {
+                dropped.insert(name.substr(name.rfind('/') + 1));
             }
-            Api::printc(COLOR_G, "Skipped %i clones, will use parent information...\n\n", cloneList.size());
-        }
-
-        pthread_mutex_init(&mutex, nullptr);
-        int maxThreads = user.getMaxThreads();
-
-        for (int i = 0; i < maxThreads; i++) {
-            pthread_create(&threads[i], nullptr, scrap_thread, &i);
-        }
-
-        for (int i = 0; i < maxThreads; i++) {
-            pthread_join(threads[i], nullptr);
-        }
-
-        pthread_mutex_destroy(&mutex);
-
-        // if fbneo/mame system process clones now based on parent game
-        if (isFbNeoSid) {
-            Api::printc(COLOR_G, "\nPlease wait, processing clones...\n");
-            for (auto &clone: cloneList) {
-                Game *game = getGameByParent(clone);
-                if (game) {
-                    gameList.games.emplace_back(*game);
-                } else {
-                    // game was not found, parent was probably not scrapped...
-                    // TODO:
-                    Api::printc(COLOR_Y, "\t%s: parent rom not scrapped/available, skipping...\n",
-                                clone.name.c_str());
-                }
+            for (const auto &name: diff.removed) {
+                dropped.insert(name.substr(name.rfind('/') + 1));
             }
+            changed.insert(diff.added.begin(), diff.added.end());
+            gameList.games.erase(std::remove_if(gameList.games.begin(), gameList.games.end(),
+                                                [&dropped](const Game &game) {
+                                                    return dropped.count(game.path) > 0;
+                                                }), gameList.games.end());
+            filesList.erase(std::remove_if(filesList.begin(), filesList.end(), [this, &changed](const Io::File &file) {
+                return changed.count(Snapshot::getName(romPath, file)) == 0;
+            }), filesList.end());
+            keptGames = gameList.games.size();
+            filesCount = (int) filesList.size();
+            Api::printc(COLOR_G, "incremental: %zu added, %zu modified, %zu removed, %zu games kept\n",
+                        diff.added.size(), diff.modified.size(), diff.removed.size(), keptGames);
         }
 
-        if (!gameList.games.empty()) {
-            // save gamelist.xml
-            gameList.save(romPath + "/gamelist.xml", args.get("-i"), args.get("-t"), args.get("-v"));
-        }
+        //SystemList::System system = systemList.findById(std::to_string(systemId));
+        Api::printc(COLOR_G, "Scrapping system '%s', let's go!\n\n", system.name.c_str());
 
-        // print results
-        FILE *f = fopen("sscrap.log", "w+");
-        Api::printc(COLOR_G, "\nAll Done... ");
-        Api::printc(COLOR_G, "found %zu/%i games\n", gameList.games.size() - missList.size(), filesCount);
-        if (f) {
-            fprintf(f, "Found %zu/%i games\n", gameList.games.size() - missList.size(), filesCount);
-        }
-        if (!missList.empty()) {
-            Api::printc(COLOR_O, "\n%zu game(s) not found:\n", missList.size());
-            if (f) {
-                fprintf(f, "\n%zu game(s) not found:\n", missList.size());
-            }
-            for (const auto &miss: missList) {
-                std::string missInfo = Utility::getZipInfoStr(romPath + "/", miss.path);
-                Api::printc(COLOR_R, "%s (%s)\n", missInfo.c_str(), miss.name.c_str());
-                if (f) {
-                    fprintf(f, "%s\n", missInfo.c_str());
-                }
-            }
-        }
-        printf("\n");
-        if (f) {
-            fclose(f);
+        scrapFiles();
+        save(keptGames);
+
+        if (args.exist("-w")) {
+            watch(watcher);
         }
     } else if (args.exist("-ml")) {
         Api::printc(COLOR_G, "\nAvailable screenscraper medias types:\n\n");
@@ -613,12 +861,22 @@ void Scrap::run() {
         }
         printf("\n");
     } else if (args.exist("-zi")) {
-        const std::string fullPath = args.get("-zi");
-        size_t sep = fullPath.rfind('/');
-        if (sep != std::string::npos) {
-            std::string zipInfo = Utility::getZipInfoStr(fullPath.substr(0, sep),
-                                                         fullPath.substr(sep + 1, fullPath.size()));
-            Api::printc(COLOR_R, "%s\n", zipInfo.c_str());
+        // group files by directory, files of the same directory are hashed together
+        std::vector<std::string> paths = args.getList("-zi");
+        for (size_t i = 0; i < paths.size();) {
+            size_t sep = paths[i].rfind('/');
+            std::string dir = sep != std::string::npos ? paths[i].substr(0, sep) : ".";
+            std::vector<std::string> files;
+            for (; i < paths.size(); i++) {
+                size_t s = paths[i].rfind('/');
+                if ((s != std::string::npos ? paths[i].substr(0, s) : ".") != dir) {
+                    break;
+                }
+                files.push_back(s != std::string::npos ? paths[i].substr(s + 1) : paths[i]);
+            }
+            for (const auto &info: Utility::getZipInfos(dir, files)) {
+                Api::printc(COLOR_R, "%s\n", Utility::getZipInfoStr(info).c_str());
+            }
         }
     } else {
         printf("\n");
@@ -627,7 +885,7 @@ void Scrap::run() {
         printf("\t\t-d                             enable debug output\n");
         printf("\t\t-sl                            list available screenscraper systems and exit\n");
         printf("\t\t-ml                            list available screenscraper medias types and exit\n");
-        printf("\t\t-zi <rom_path>                 show zip information (size, crc, md5, sha1) and exit\n");
+        printf("\t\t-zi <rom_path> [rom_path...]   show zip information (size, crc, md5, sha1, sha256) and exit\n");
         printf("\t\t-sid <system_id>               screenscraper system id to scrap\n");
         printf("\t\t-r <roms_path>                 path to roms files to scrap\n");
         printf("\t\t-i <mediaType>                 use given media type for image\n");
@@ -635,6 +893,14 @@ void Scrap::run() {
         printf("\t\t-v <mediaType>                 use given media type for video\n");
         printf("\t\t-c                           download medias for clones (else use parent)\n");
         printf("\t\t-filter <ext>                  only scrap files with this extension\n");
+        printf("\t\t-cache <cache_path>            cache screenscraper games information in this directory\n");
+        printf("\t\t                               (systems and medias lists are cached per server url, default: ~/.cache/sscrap)\n");
+        printf("\t\t-cachettl <days>               cached games information expiration (default: 30)\n");
+        printf("\t\t-cachenegttl <days>            cached \"game not found\" expiration (default: 7)\n");
+        printf("\t\t-nohashcache                   don't cache roms hashes (\"%s\" file in roms path)\n", SS_HASHCACHE_FILE);
+        printf("\t\t-w                             watch roms path and scrap new or modified roms as they land (ctrl+c to quit)\n");
+        printf("\t\t-inc                           only scrap roms added or modified since the last run (\"%s\" file in roms path)\n", SS_SNAPSHOT_FILE);
+        printf("\t\t-url <api_url>                 screenscraper api url (default: %s)\n", Api::ss_baseurl.c_str());
         printf("\n\tsscrap customs systemid (fbneo):\n");
         printf("\t\t750: ColecoVision\n");
         printf("\t\t751: Game Gear\n");
@@ -663,6 +929,9 @@ int main(int argc, char *argv[]) {
     ArgumentParser args(argc, argv);
     scrap = new Scrap(args);
     scrap->run();
+    delete scrap;
+
+    Curl::cleanup();
 
     return 0;
 }
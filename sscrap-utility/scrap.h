@@ -6,6 +6,7 @@
 #define SSCRAP_SCRAP_H
 
 #include <pthread.h>
+#include <thread>
 
 #ifndef _MSC_VER
 
@@ -36,11 +37,21 @@ public:
 
     explicit Scrap(const ArgumentParser &parser);
 
+    ~Scrap();
+
     ss_api::Game scrapGame(int tid, int tryCount, int sid, int remainingFiles, const std::string &fileName,
                            const std::string &filePath, const std::string &searchName);
 
     void run();
 
+    void scrapFiles();
+
+    // save gamelist.xml, hashes and snapshot (if any), and print results ("keptGames" were not scrapped again)
+    void save(size_t keptGames);
+
+    // scrap roms as they land in the roms path, until the watch fails
+    void watch(ss_api::Watcher &watcher);
+
     void parseSid(int sid);
 
     bool isFbnClone(const ss_api::Io::File &file);
@@ -58,6 +69,11 @@ public:
     std::vector<ss_api::Io::File> filesList;
     std::vector<ss_api::Io::File> cloneList;
     std::vector<MissFile> missList;
+    std::vector<std::string> filters;
+    bool recursive = false;
+    // "-inc" and "-w" only (snapshotPath is empty otherwise)
+    ss_api::Snapshot snapshot;
+    std::string snapshotPath;
     ss_api::System system;
     int sscrapSystemId = 0;
     bool isFbNeoSid = false;
@@ -65,6 +81,7 @@ public:
     int filesCount = 0;
     pthread_t threads[15]{};
     pthread_mutex_t mutex;
+    std::thread refreshThread;
 };
 
 #endif //SSCRAP_SCRAP_H
@@ -3,6 +3,8 @@
 //
 
 #include <cstring>
+#include <memory>
+#include <future>
 #include <algorithm>
 
 #ifndef __VITA__
@@ -17,8 +19,18 @@
 
 using namespace ss_api;
 
-static hashwrapper *md5Wrapper;
-static hashwrapper *sha1Wrapper;
+// above this size, the crc is computed in parallel (Api::getFileCrc) while md5/sha1/sha256 are computed here
+#define SS_HASH_PARALLEL_SIZE (64 * 1024 * 1024)
+
+static std::string toHex(const unsigned char *data, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(size * 2, '0');
+    for (size_t i = 0; i < size; i++) {
+        hex[i * 2] = digits[data[i] >> 4];
+        hex[i * 2 + 1] = digits[data[i] & 0x0f];
+    }
+    return hex;
+}
 
 std::string Utility::removeExt(const std::string &str) {
     size_t pos = str.find_last_of('.');
@@ -32,12 +44,31 @@ std::string Utility::removeExt(const std::string &str) {
 int Utility::parseInt(const std::string &str, int defValue) {
     char *end = nullptr;
     long i = strtol(str.c_str(), &end, 10);
-    if (end != nullptr) {
+    // strtol always sets "end", it is left at the start when nothing was parsed
+    if (end != str.c_str()) {
         return (int) i;
     }
     return defValue;
 }
 
+std::string Utility::getUserCachePath() {
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    if (xdg != nullptr && xdg[0] != '\0') {
+        return std::string(xdg) + "/sscrap";
+    }
+
+    const char *home = getenv("HOME");
+    if (home == nullptr || home[0] == '\0') {
+        return "";
+    }
+    std::string cache = std::string(home) + "/.cache";
+    if (!Io::exist(cache)) {
+        Io::makedir(cache);
+    }
+
+    return cache + "/sscrap";
+}
+
 std::string Utility::getExt(const std::string &file) {
 
     char ext[3];
@@ -53,87 +84,308 @@ std::string Utility::getExt(const std::string &file) {
     return ext;
 }
 
-std::string Utility::getRomCrc(const std::string &zipPath, std::vector<std::string> whiteList) {
+#ifndef __VITA__
 
-    char *zipFileName, *data, buffer[16];
-    memset(buffer, 0, 16);
+// inflate the current zip entry through a small buffer and compare with the stored crc
+static bool verifyCurrentFile(unzFile zip, unsigned long crc) {
+    if (unzOpenCurrentFile(zip) != UNZ_OK) {
+        return false;
+    }
 
-    if (!Io::endsWith(zipPath, ".zip", false)) {
-        return "";
+    unsigned char buffer[64 * 1024];
+    uint32_t value = 0;
+    int size;
+    while ((size = unzReadCurrentFile(zip, buffer, sizeof(buffer))) > 0) {
+        value = Crc32::update(value, buffer, (size_t) size);
     }
 
+    // unzCloseCurrentFile also reports UNZ_CRCERROR
+    bool ok = unzCloseCurrentFile(zip) == UNZ_OK && size == 0;
+    return ok && value == crc;
+}
+
+#endif
+
+std::vector<Utility::ZipEntry> Utility::getZipEntries(const std::string &zipPath, bool verify) {
+
+    std::vector<ZipEntry> entries;
+
 #ifndef __VITA__
     unzFile zip = unzOpen(zipPath.c_str());
     if (zip == nullptr) {
-        SS_PRINT("could not open zip file for crc check (%s)\n", zipPath.c_str());
-        return buffer;
+        SS_PRINT("could not open zip file (%s)\n", zipPath.c_str());
+        return entries;
     }
 
+    std::vector<char> name(256);
     if (unzGoToFirstFile(zip) == UNZ_OK) {
         do {
-            if (unzOpenCurrentFile(zip) == UNZ_OK) {
-                unz_file_info fileInfo;
-                memset(&fileInfo, 0, sizeof(unz_file_info));
-                if (unzGetCurrentFileInfo(zip, &fileInfo, nullptr, 0,
-                                          nullptr, 0, nullptr, 0) == UNZ_OK) {
-                    zipFileName = (char *) malloc((uLong) fileInfo.size_filename + 1);
-                    unzGetCurrentFileInfo(zip, &fileInfo, zipFileName, fileInfo.size_filename + 1,
-                                          nullptr, 0, nullptr, 0);
-                    zipFileName[(uLong) fileInfo.size_filename] = '\0';
-                    std::string ext = getExt(std::string(zipFileName));
-                    if (whiteList.empty() || std::find(whiteList.begin(), whiteList.end(), ext) != whiteList.end()) {
-                        data = (char *) malloc(fileInfo.uncompressed_size);
-                        unzReadCurrentFile(zip, data, (unsigned int) fileInfo.uncompressed_size);
-                        uLong crc = crc32(0L, (const Bytef *) data, fileInfo.uncompressed_size) & 0xffffffff;
-                        free(data);
-                        free(zipFileName);
-                        unzClose(zip);
-                        snprintf(buffer, 16, "%08lx", crc);
-                        return buffer;
-                    }
-                    free(zipFileName);
-                }
-                unzCloseCurrentFile(zip);
+            unz_file_info fileInfo;
+            memset(&fileInfo, 0, sizeof(unz_file_info));
+            if (unzGetCurrentFileInfo(zip, &fileInfo, name.data(), (uLong) name.size(),
+                                      nullptr, 0, nullptr, 0) != UNZ_OK) {
+                continue;
+            }
+            if (fileInfo.size_filename >= name.size()) {
+                name.resize(fileInfo.size_filename + 1);
+                unzGetCurrentFileInfo(zip, &fileInfo, name.data(), (uLong) name.size(),
+                                      nullptr, 0, nullptr, 0);
+            }
+
+            ZipEntry entry;
+            entry.name = std::string(name.data(), fileInfo.size_filename);
+            entry.size = fileInfo.uncompressed_size;
+            entry.compressedSize = fileInfo.compressed_size;
+            entry.crc = fileInfo.crc & 0xffffffff;
+            if (verify && !entry.name.empty() && entry.name.back() != '/') {
+                entry.valid = verifyCurrentFile(zip, entry.crc);
             }
+            entries.push_back(entry);
         } while (unzGoToNextFile(zip) == UNZ_OK);
     }
 
     unzClose(zip);
 #endif
-    return buffer;
+    return entries;
 }
 
-Utility::ZipInfo Utility::getZipInfo(const std::string &path, const std::string &file) {
+std::string Utility::getRomCrc(const std::string &zipPath, std::vector<std::string> whiteList, bool verify) {
 
-    ZipInfo info;
-    info.name = file;
-    std::string fullPath = path + "/" + file;
+    if (!Io::endsWith(zipPath, ".zip", false)) {
+        return "";
+    }
 
-    if (!Io::exist(fullPath)) {
-        return info;
+    // only the default (first rom) crc is cached
+    std::string cached;
+    bool cache = whiteList.empty();
+    if (cache && !verify && HashCache::get(zipPath, HashCache::RomCrc, &cached)) {
+        return cached;
     }
 
-    if (!md5Wrapper) {
-        md5Wrapper = new md5wrapper();
-        sha1Wrapper = new sha1wrapper();
+    for (const ZipEntry &entry: getZipEntries(zipPath)) {
+        // skip directories
+        if (entry.name.empty() || entry.name.back() == '/') {
+            continue;
+        }
+        std::string ext = getExt(entry.name);
+        if (whiteList.empty() || std::find(whiteList.begin(), whiteList.end(), ext) != whiteList.end()) {
+#ifndef __VITA__
+            if (verify) {
+                unzFile zip = unzOpen(zipPath.c_str());
+                bool valid = zip != nullptr && unzLocateFile(zip, entry.name.c_str(), 1) == UNZ_OK
+                             && verifyCurrentFile(zip, entry.crc);
+                if (zip != nullptr) {
+                    unzClose(zip);
+                }
+                if (!valid) {
+                    SS_PRINT("zip entry crc mismatch (%s: %s)\n", zipPath.c_str(), entry.name.c_str());
+                    return "";
+                }
+            }
+#endif
+            char buffer[16];
+            snprintf(buffer, 16, "%08lx", entry.crc);
+            if (cache) {
+                HashCache::put(zipPath, HashCache::RomCrc, buffer);
+            }
+            return buffer;
+        }
     }
 
-    info.name = file;
-    info.size = std::to_string(Io::getSize(fullPath));
-    info.crc = Api::getFileCrc(fullPath);
-    info.md5 = md5Wrapper->getHashFromFile(fullPath);
-    info.sha1 = sha1Wrapper->getHashFromFile(fullPath);
+    return "";
+}
+
+std::vector<Utility::FileHashes> Utility::getFilesHashes(const std::vector<std::string> &paths,
+                                                        bool crc, bool md5, bool sha1, bool sha256) {
+    struct Job {
+        size_t index = 0;
+        std::unique_ptr<Io::Reader> reader;
+        HL_MULTIHASH_CTX ctx;
+        bool crc = false;
+        uint32_t crcValue = 0;
+        std::future<std::string> crcFuture;
+    };
 
-    return info;
+    std::vector<FileHashes> hashes(paths.size());
+    size_t next = 0;
+
+    // open the next file which needs hashing in this lane
+    auto start = [&](Job &job) -> bool {
+        while (next < paths.size()) {
+            size_t index = next++;
+            const std::string &path = paths[index];
+            FileHashes &h = hashes[index];
+            // skip hashes which are already known for this (unchanged) file
+            bool needCrc = crc && !HashCache::get(path, HashCache::Crc, &h.crc);
+            bool needMd5 = md5 && !HashCache::get(path, HashCache::Md5, &h.md5);
+            bool needSha1 = sha1 && !HashCache::get(path, HashCache::Sha1, &h.sha1);
+            bool needSha256 = sha256 && !HashCache::get(path, HashCache::Sha256, &h.sha256);
+            if (!needCrc && !needMd5 && !needSha1 && !needSha256) {
+                h.ok = true;
+                continue;
+            }
+
+            job.reader.reset(new Io::Reader(path));
+            if (!job.reader->isOpen()) {
+                continue;
+            }
+            job.index = index;
+            job.crc = needCrc;
+            job.crcValue = 0;
+            multihash::init(&job.ctx, (needMd5 ? HL_MULTIHASH_MD5 : 0) | (needSha1 ? HL_MULTIHASH_SHA1 : 0)
+                                      | (needSha256 ? HL_MULTIHASH_SHA256 : 0));
+
+            // md5 and sha can't be split in ranges, overlap them with the (multi-threaded) crc
+            if (needCrc && (needMd5 || needSha1 || needSha256) && Io::getSize(path) >= SS_HASH_PARALLEL_SIZE) {
+                job.crcFuture = std::async(std::launch::async, [path] {
+                    return Api::getFileCrc(path);
+                });
+                job.crc = false;
+            }
+            return true;
+        }
+        return false;
+    };
+
+    auto finish = [&](Job &job) {
+        const std::string &path = paths[job.index];
+        FileHashes &h = hashes[job.index];
+        h.ok = !job.reader->hasError();
+        job.reader.reset();
+
+        hl_uint8 md5Digest[16], sha1Digest[20], sha256Digest[32];
+        multihash::final(&job.ctx, md5Digest, sha1Digest, sha256Digest);
+        if (job.crcFuture.valid()) {
+            h.crc = job.crcFuture.get();
+            h.ok = h.ok && !h.crc.empty();
+        }
+        if (!h.ok) {
+            return;
+        }
+
+        if (job.crc) {
+            char hex[16];
+            snprintf(hex, 16, "%08lx", (unsigned long) job.crcValue);
+            h.crc = hex;
+            HashCache::put(path, HashCache::Crc, h.crc);
+        }
+        if (job.ctx.digests & HL_MULTIHASH_MD5) {
+            h.md5 = toHex(md5Digest, sizeof(md5Digest));
+            HashCache::put(path, HashCache::Md5, h.md5);
+        }
+        if (job.ctx.digests & HL_MULTIHASH_SHA1) {
+            h.sha1 = toHex(sha1Digest, sizeof(sha1Digest));
+            HashCache::put(path, HashCache::Sha1, h.sha1);
+        }
+        if (job.ctx.digests & HL_MULTIHASH_SHA256) {
+            h.sha256 = toHex(sha256Digest, sizeof(sha256Digest));
+            HashCache::put(path, HashCache::Sha256, h.sha256);
+        }
+    };
+
+    // one file per lane, each round feeds the next chunk of every file to the multi-buffer hasher
+    Job jobs[HL_MULTIHASH_LANES];
+    bool active[HL_MULTIHASH_LANES];
+    for (int i = 0; i < HL_MULTIHASH_LANES; i++) {
+        active[i] = start(jobs[i]);
+    }
+
+    while (std::find(active, active + HL_MULTIHASH_LANES, true) != active + HL_MULTIHASH_LANES) {
+        HL_MULTIHASH_CTX *contexts[HL_MULTIHASH_LANES];
+        const hl_uint8 *data[HL_MULTIHASH_LANES];
+        unsigned long length[HL_MULTIHASH_LANES];
+        int count = 0;
+
+        for (int i = 0; i < HL_MULTIHASH_LANES; i++) {
+            if (!active[i]) {
+                continue;
+            }
+            const unsigned char *chunk;
+            size_t size;
+            if (jobs[i].reader->next(&chunk, &size)) {
+                if (jobs[i].crc) {
+                    jobs[i].crcValue = Crc32::update(jobs[i].crcValue, chunk, size);
+                }
+                contexts[count] = &jobs[i].ctx;
+                data[count] = chunk;
+                length[count] = (unsigned long) size;
+                count++;
+            } else {
+                finish(jobs[i]);
+                active[i] = start(jobs[i]);
+            }
+        }
+
+        if (count > 0) {
+            multihash::update(contexts, data, length, count);
+        }
+    }
+
+    return hashes;
 }
 
-std::string Utility::getZipInfoStr(const std::string &path, const std::string &file) {
+bool Utility::getFileHashes(const std::string &path, std::string *crc,
+                            std::string *md5, std::string *sha1, std::string *sha256) {
+    FileHashes hashes = getFilesHashes({path}, crc != nullptr, md5 != nullptr,
+                                       sha1 != nullptr, sha256 != nullptr)[0];
+    if (!hashes.ok) {
+        return false;
+    }
 
-    if (!md5Wrapper) {
-        md5Wrapper = new md5wrapper();
-        sha1Wrapper = new sha1wrapper();
+    if (crc) {
+        *crc = hashes.crc;
     }
+    if (md5) {
+        *md5 = hashes.md5;
+    }
+    if (sha1) {
+        *sha1 = hashes.sha1;
+    }
+    if (sha256) {
+        *sha256 = hashes.sha256;
+    }
+
+    return true;
+}
 
-    ZipInfo info = getZipInfo(path, file);
-    return info.name + "|" + info.size + "|" + info.serial + "|" + info.crc + "|" + info.md5 + "|" + info.sha1;
+std::vector<Utility::ZipInfo> Utility::getZipInfos(const std::string &path, const std::vector<std::string> &files) {
+
+    std::vector<ZipInfo> infos(files.size());
+    std::vector<std::string> paths;
+    std::vector<size_t> indexes;
+
+    for (size_t i = 0; i < files.size(); i++) {
+        infos[i].name = files[i];
+        std::string fullPath = path + "/" + files[i];
+        if (!Io::exist(fullPath)) {
+            continue;
+        }
+        infos[i].size = std::to_string(Io::getSize(fullPath));
+        paths.push_back(fullPath);
+        indexes.push_back(i);
+    }
+
+    std::vector<FileHashes> hashes = getFilesHashes(paths);
+    for (size_t i = 0; i < hashes.size(); i++) {
+        ZipInfo &info = infos[indexes[i]];
+        info.crc = hashes[i].crc;
+        info.md5 = hashes[i].md5;
+        info.sha1 = hashes[i].sha1;
+        info.sha256 = hashes[i].sha256;
+    }
+
+    return infos;
+}
+
+Utility::ZipInfo Utility::getZipInfo(const std::string &path, const std::string &file) {
+    return getZipInfos(path, {file})[0];
+}
+
+std::string Utility::getZipInfoStr(const ZipInfo &info) {
+    return info.name + "|" + info.size + "|" + info.serial + "|" + info.crc + "|" + info.md5 + "|" + info.sha1
+           + "|" + info.sha256;
+}
+
+std::string Utility::getZipInfoStr(const std::string &path, const std::string &file) {
+    return getZipInfoStr(getZipInfo(path, file));
 }
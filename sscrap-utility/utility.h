@@ -9,6 +9,7 @@
 #include <vector>
 #include <ss_game.h>
 #include "hashlibpp/hashlibpp.h"
+#include "hashlibpp/hl_multihash.h"
 
 class Utility {
 public:
@@ -20,6 +21,24 @@ public:
         std::string crc;
         std::string md5;
         std::string sha1;
+        std::string sha256;
+    };
+
+    struct FileHashes {
+        std::string crc;
+        std::string md5;
+        std::string sha1;
+        std::string sha256;
+        bool ok = false;
+    };
+
+    struct ZipEntry {
+        std::string name;
+        unsigned long size = 0;
+        unsigned long compressedSize = 0;
+        unsigned long crc = 0;
+        // false if "verify" was requested and the entry data doesn't match its crc
+        bool valid = true;
     };
 
     static std::string removeExt(const std::string &str);
@@ -28,10 +47,33 @@ public:
 
     static std::string getExt(const std::string &file);
 
-    static std::string getRomCrc(const std::string &zipPath, std::vector<std::string> whiteList = {});
+    // per user cache directory ($XDG_CACHE_HOME/sscrap or ~/.cache/sscrap), empty if there is none
+    static std::string getUserCachePath();
+
+    // list zip entries (name, size, crc) from the zip central directory, nothing is decompressed
+    // unless "verify" is set, in which case each entry is inflated and checked against its crc
+    static std::vector<ZipEntry> getZipEntries(const std::string &zipPath, bool verify = false);
+
+    // crc of the first (white listed) rom in the zip, as stored in the zip central directory
+    static std::string getRomCrc(const std::string &zipPath, std::vector<std::string> whiteList = {},
+                                 bool verify = false);
+
+    // hash a batch of files, each file is read once and up to 8 files are hashed together
+    // (md5/sha1/sha256 simd lanes). "ok" is false if a file could not be read
+    static std::vector<FileHashes> getFilesHashes(const std::vector<std::string> &paths,
+                                                  bool crc = true, bool md5 = true, bool sha1 = true,
+                                                  bool sha256 = true);
+
+    // single file version of getFilesHashes (nullptr to skip a digest)
+    static bool getFileHashes(const std::string &path, std::string *crc,
+                              std::string *md5, std::string *sha1, std::string *sha256 = nullptr);
+
+    static std::vector<ZipInfo> getZipInfos(const std::string &path, const std::vector<std::string> &files);
 
     static ZipInfo getZipInfo(const std::string &path, const std::string &file);
 
+    static std::string getZipInfoStr(const ZipInfo &info);
+
     static std::string getZipInfoStr(const std::string &path, const std::string &file);
 
     //static void replace(std::string &str, const std::string &from, const std::string &to);